@@ -1,18 +1,36 @@
 #include "PlcBridge.h"
 #include "../modbus/ModbusManager.h"
 #include "../modbus/SignalManager.h"
+#include "../modbus/PollScheduler.h"
 #include "../config/ConfigManager.h"
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
 #include <QDate>
 #include <QCoreApplication>
+#include <QtEndian>
 
 /**
  * @file PlcBridge.cpp
  * @brief PLC WebChannel 桥接类实现
  */
 
+namespace {
+/** WebChannel 按 QVariant 序列化异步结果 */
+QFuture<QVariant> toVariantFuture(QFuture<QVariantMap> future)
+{
+    return future.then([](const QVariantMap &map) {
+        return QVariant(map);
+    });
+}
+
+/** Float64 无法精确表示全部 64 位整数，长整数信号不打包 */
+bool isPackable(DecodeKind kind)
+{
+    return kind != DecodeKind::Int64;
+}
+}
+
 PlcBridge::PlcBridge(ModbusManager *modbusManager,
                      SignalManager *signalManager,
                      ConfigManager *configManager,
@@ -21,8 +39,13 @@ PlcBridge::PlcBridge(ModbusManager *modbusManager,
     , m_modbusManager(modbusManager)
     , m_signalManager(signalManager)
     , m_configManager(configManager)
-    , m_pollTimer(new QTimer(this))
+    , m_pollScheduler(new PollScheduler(this))
+    , m_fullSyncTimer(new QTimer(this))
     , m_isPolling(false)
+    , m_valueVersion(0)
+    , m_compactPush(false)
+    , m_pushTimer(new QTimer(this))
+    , m_pushIntervalMs(1000 / DefaultUiRefreshHz)
 {
     // 连接状态变化
     connect(m_modbusManager, &ModbusManager::connectionChanged,
@@ -32,6 +55,10 @@ PlcBridge::PlcBridge(ModbusManager *modbusManager,
     connect(m_modbusManager, &ModbusManager::errorOccurred,
             this, &PlcBridge::errorOccurred);
 
+    // 信号值变化以增量形式推送
+    connect(m_signalManager, &SignalManager::signalValuesChanged,
+            this, &PlcBridge::onSignalValuesChanged);
+
     // 信号配置加载完成
     connect(m_signalManager, &SignalManager::signalsLoaded,
             this, &PlcBridge::onSignalsLoaded);
@@ -40,9 +67,25 @@ PlcBridge::PlcBridge(ModbusManager *modbusManager,
     connect(m_configManager, &ConfigManager::syncCompleted,
             this, &PlcBridge::onSyncCompleted);
 
-    // 轮询定时器
-    connect(m_pollTimer, &QTimer::timeout,
-            this, &PlcBridge::onPollTimer);
+    // 轮询调度器：各轮询等级按各自周期独立读取，不同等级的周期可以同时在途，按单调时钟补偿漂移
+    // 按等级顺序注册，任务 ID 与 SignalManager::PollClass 一致，同时到期时快速等级先发起
+    for (int pollClass = 0; pollClass < SignalManager::PollClassCount; ++pollClass) {
+        const auto cls = static_cast<SignalManager::PollClass>(pollClass);
+        m_pollScheduler->addTask(SignalManager::pollClassName(cls),
+                                 [this, cls]() { return pollCycle(cls); },
+                                 DefaultPollIntervals[pollClass]);
+    }
+
+    // 全量同步定时器，兜底前端丢失的增量
+    m_fullSyncTimer->setInterval(FullSyncIntervalMs);
+    connect(m_fullSyncTimer, &QTimer::timeout,
+            this, &PlcBridge::onFullSyncTimer);
+
+    // 推送限速定时器：合并两帧之间的变化
+    m_pushTimer->setSingleShot(true);
+    m_pushTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_pushTimer, &QTimer::timeout,
+            this, &PlcBridge::onPushTimer);
 }
 
 bool PlcBridge::isConnected() const
@@ -50,14 +93,30 @@ bool PlcBridge::isConnected() const
     return m_modbusManager ? m_modbusManager->isConnected() : false;
 }
 
-QVariantList PlcBridge::readData(int address, int count)
+QFuture<QVariant> PlcBridge::readData(int address, int count)
 {
-    return m_modbusManager->readHoldingRegisters(address, count);
+    // 区间已被轮询刷新的影像覆盖时直接应答，不占用总线
+    const QVector<quint16> cached = m_signalManager->readImage(ModbusManager::HoldingRegisters, address, count);
+    if (!cached.isEmpty()) {
+        return QtFuture::makeReadyValueFuture(QVariant(ModbusManager::toVariantList(cached)));
+    }
+    return m_modbusManager->readHoldingRegistersAsync(address, count).then([](const QVector<quint16> &values) {
+        return QVariant(ModbusManager::toVariantList(values));
+    });
 }
 
-bool PlcBridge::writeData(int address, const QVariantList &values)
+QFuture<QVariant> PlcBridge::writeData(int address, const QVariantList &values)
 {
-    return m_modbusManager->writeRegisters(address, values);
+    QVector<quint16> data;
+    data.reserve(values.size());
+    for (const QVariant &v : values) {
+        data.append(static_cast<quint16>(v.toUInt()));
+    }
+
+    // 与信号写入共用写入顺序，不会与按位改写交错
+    return m_signalManager->writeRegisters(ModbusManager::HoldingRegisters, address, data).then([](bool ok) {
+        return QVariant(ok);
+    });
 }
 
 QVariantList PlcBridge::getSignals()
@@ -76,10 +135,14 @@ QVariantList PlcBridge::getSignals()
         map["registerCount"] = signal.registerCount;
         map["scaleFactor"] = signal.scaleFactor;
         map["offsetValue"] = signal.offsetValue;
+        map["bitIndex"] = signal.bitIndex;
         map["unit"] = signal.unit;
         map["plcAreaType"] = signal.plcAreaType;
         map["paramGroup"] = signal.paramGroup;
         map["isActive"] = signal.isActive;
+        map["deadband"] = signal.deadband;
+        map["deadbandType"] = signal.deadbandPercent ? QStringLiteral("percent") : QStringLiteral("absolute");
+        map["minReportInterval"] = signal.minReportInterval;
         result.append(map);
     }
     return result;
@@ -90,19 +153,104 @@ void PlcBridge::refreshSignals()
     m_configManager->syncNow();
 }
 
-QVariant PlcBridge::readBySignalCode(const QString &signalCode)
+QFuture<QVariant> PlcBridge::readBySignalCode(const QString &signalCode, int maxAgeMs)
+{
+    return m_signalManager->readSignalValue(signalCode, maxAgeMs);
+}
+
+QFuture<QVariant> PlcBridge::writeBySignalCode(const QString &signalCode, const QVariant &value)
+{
+    return m_signalManager->writeSignalValue(signalCode, value).then([](bool ok) {
+        return QVariant(ok);
+    });
+}
+
+QFuture<QVariant> PlcBridge::writeSignalValues(const QVariantMap &values)
+{
+    return toVariantFuture(m_signalManager->writeSignalValues(values));
+}
+
+QFuture<QVariant> PlcBridge::readGroupSnapshot(const QString &paramGroup)
+{
+    return toVariantFuture(m_signalManager->readGroupSnapshot(paramGroup));
+}
+
+QFuture<QVariant> PlcBridge::downloadRecipe(const QString &paramGroup, const QVariantMap &values)
+{
+    return toVariantFuture(m_signalManager->downloadRecipe(paramGroup, values));
+}
+
+QFuture<QVariant> PlcBridge::batchRead(const QStringList &signalCodes, int maxAgeMs)
+{
+    return toVariantFuture(m_signalManager->readSignalValues(signalCodes, maxAgeMs));
+}
+
+QVariantMap PlcBridge::readCachedSignals(const QStringList &signalCodes)
+{
+    return m_signalManager->cachedValues(signalCodes);
+}
+
+QVariantMap PlcBridge::getSignalValues()
 {
-    return m_signalManager->readSignalValue(signalCode);
+    QVariantMap result;
+    result["version"] = m_valueVersion;
+    result["values"] = m_signalManager->currentValues();
+    return result;
 }
 
-bool PlcBridge::writeBySignalCode(const QString &signalCode, const QVariant &value)
+void PlcBridge::setCompactPush(bool enabled)
 {
-    return m_signalManager->writeSignalValue(signalCode, value);
+    m_compactPush = enabled;
 }
 
-QVariantMap PlcBridge::batchRead(const QStringList &signalCodes)
+QVariantMap PlcBridge::getSignalSchema()
 {
-    return m_signalManager->readSignalValues(signalCodes);
+    const SignalTable &table = m_signalManager->signalTable();
+
+    QVariantList codes;
+    QVariantList types;
+    codes.reserve(table.size());
+    types.reserve(table.size());
+    for (SignalHandle handle = 0; handle < table.size(); ++handle) {
+        codes.append(table.code(handle));
+        const DecodeKind kind = table.decodeKind(handle);
+        if (kind == DecodeKind::Bit || kind == DecodeKind::BitInWord) {
+            types.append(QStringLiteral("bool"));
+        } else if (!isPackable(kind)) {
+            types.append(QStringLiteral("int64"));
+        } else {
+            types.append(QStringLiteral("number"));
+        }
+    }
+
+    QVariantMap schema;
+    schema["schemaVersion"] = static_cast<int>(m_signalManager->generation());
+    schema["codes"] = codes;
+    schema["types"] = types;
+    return schema;
+}
+
+void PlcBridge::setUiRefreshRate(int hz)
+{
+    m_pushIntervalMs = 1000 / qBound(1, hz, 60);
+}
+
+void PlcBridge::setUrgentSignals(const QStringList &signalCodes)
+{
+    m_urgentCodes = QSet<QString>(signalCodes.begin(), signalCodes.end());
+    resolveUrgentSignals();
+}
+
+void PlcBridge::resolveUrgentSignals()
+{
+    const SignalTable &table = m_signalManager->signalTable();
+    m_urgentFlags.fill(false, table.size());
+    for (const QString &code : std::as_const(m_urgentCodes)) {
+        const SignalHandle handle = table.handleOf(code);
+        if (handle != SignalTable::InvalidHandle) {
+            m_urgentFlags[handle] = true;
+        }
+    }
 }
 
 QVariantMap PlcBridge::getDeviceConfig()
@@ -117,7 +265,9 @@ void PlcBridge::startPolling(int intervalMs)
 {
     if (!m_isPolling) {
         m_isPolling = true;
-        m_pollTimer->start(intervalMs);
+        m_pollScheduler->setInterval(SignalManager::NormalPoll, intervalMs);
+        m_pollScheduler->start();
+        m_fullSyncTimer->start();
         emit pollingChanged(true);
     }
 }
@@ -126,28 +276,182 @@ void PlcBridge::stopPolling()
 {
     if (m_isPolling) {
         m_isPolling = false;
-        m_pollTimer->stop();
+        m_pollScheduler->stop();
+        m_fullSyncTimer->stop();
         emit pollingChanged(false);
     }
 }
 
-void PlcBridge::onPollTimer()
+int PlcBridge::subscribe(const QStringList &signalCodes, const QStringList &paramGroups)
+{
+    return m_signalManager->addSubscription(signalCodes, paramGroups);
+}
+
+void PlcBridge::unsubscribe(int subscriptionId)
+{
+    m_signalManager->removeSubscription(subscriptionId);
+}
+
+QVariantMap PlcBridge::getPollStats()
+{
+    QVariantMap stats = m_pollScheduler->stats();
+    stats["link"] = m_modbusManager->linkStats();
+    return stats;
+}
+
+QStringList PlcBridge::getQuarantinedSignals()
+{
+    return m_signalManager->quarantinedSignals();
+}
+
+void PlcBridge::setPollClassInterval(const QString &pollClass, int intervalMs)
+{
+    const SignalManager::PollClass cls = SignalManager::pollClassFromName(pollClass, SignalManager::PollClassCount);
+    if (cls == SignalManager::PollClassCount) {
+        emit errorOccurred(QStringLiteral("未知的轮询等级: %1").arg(pollClass));
+        return;
+    }
+    m_pollScheduler->setInterval(cls, intervalMs);
+}
+
+void PlcBridge::setGroupPollClass(const QString &paramGroup, const QString &pollClass)
+{
+    m_signalManager->setGroupPollClass(paramGroup, SignalManager::pollClassFromName(pollClass));
+}
+
+QFuture<int> PlcBridge::pollCycle(SignalManager::PollClass pollClass)
 {
     if (!m_modbusManager->isConnected()) {
+        return QFuture<int>();
+    }
+
+    // 重试预算由所有等级共用，只按常规等级的周期补满；快速等级周期很短，
+    // 每个周期都补满会使链路劣化时的重试不受限制
+    if (pollClass == SignalManager::NormalPoll) {
+        m_modbusManager->beginCycle();
+    }
+
+    // 变化检测在 SignalManager 中完成，有变化时通过 signalValuesChanged 转发
+    return m_signalManager->pollActiveSignalsAsync(pollClass);
+}
+
+void PlcBridge::onSignalValuesChanged(const QVector<int> &handles)
+{
+    // 合并到待推送列表，推送时读取信号表中的最新值
+    bool urgent = false;
+    m_pendingFlags.resize(m_signalManager->signalTable().size());
+    for (int handle : handles) {
+        if (!m_pendingFlags[handle]) {
+            m_pendingFlags[handle] = true;
+            m_pendingHandles.append(handle);
+        }
+        urgent = urgent || m_urgentFlags.value(handle);
+    }
+
+    // 紧急信号或距上次推送已超过一帧时立即推送，否则等到下一帧
+    const qint64 sinceLastPush = m_lastPushClock.isValid()
+        ? m_lastPushClock.elapsed() : m_pushIntervalMs;
+    if (urgent || sinceLastPush >= m_pushIntervalMs) {
+        flushPendingValues();
+    } else if (!m_pushTimer->isActive()) {
+        m_pushTimer->start(m_pushIntervalMs - static_cast<int>(sinceLastPush));
+    }
+}
+
+void PlcBridge::onPushTimer()
+{
+    flushPendingValues();
+}
+
+void PlcBridge::flushPendingValues()
+{
+    m_pushTimer->stop();
+    if (m_pendingHandles.isEmpty()) {
         return;
     }
 
-    QVariantMap values = m_signalManager->readAllActiveSignals();
+    const QVector<int> handles = m_pendingHandles;
+    clearPendingValues();
+    pushValues(handles, false);
+    m_lastPushClock.start();
+}
 
-    // 检测变化，仅在有变化时发射信号
-    if (values != m_lastValues) {
-        m_lastValues = values;
-        emit signalValuesChanged(values);
+void PlcBridge::clearPendingValues()
+{
+    for (int handle : std::as_const(m_pendingHandles)) {
+        m_pendingFlags[handle] = false;
     }
+    m_pendingHandles.clear();
+}
+
+void PlcBridge::onFullSyncTimer()
+{
+    // 全量同步已包含所有待推送的变化
+    m_pushTimer->stop();
+    clearPendingValues();
+    pushValues(m_signalManager->valuedHandles(), true);
+    m_lastPushClock.start();
+}
+
+void PlcBridge::pushValues(const QVector<int> &handles, bool fullSync)
+{
+    if (!m_compactPush) {
+        emit signalValuesChanged(m_signalManager->valuesOf(handles), ++m_valueVersion, fullSync);
+        return;
+    }
+
+    const SignalTable &table = m_signalManager->signalTable();
+    QVector<int> packable;
+    QVector<int> unpackable;
+    packable.reserve(handles.size());
+    for (int handle : handles) {
+        if (isPackable(table.decodeKind(handle))) {
+            packable.append(handle);
+        } else {
+            unpackable.append(handle);
+        }
+    }
+
+    // 全量同步先以紧凑数据替换全部值，不可打包的信号随后以下一个版本号的增量补上
+    if (fullSync || !packable.isEmpty()) {
+        emit signalValuesPacked(packValues(packable),
+                                static_cast<int>(m_signalManager->generation()),
+                                ++m_valueVersion, fullSync);
+    }
+    if (!unpackable.isEmpty()) {
+        emit signalValuesChanged(m_signalManager->valuesOf(unpackable), ++m_valueVersion, false);
+    }
+}
+
+QString PlcBridge::packValues(const QVector<int> &handles) const
+{
+    const SignalTable &table = m_signalManager->signalTable();
+    const int count = handles.size();
+
+    // 值在前保证 Float64 数组按 8 字节对齐，前端可直接映射为 TypedArray
+    QByteArray buffer(count * (sizeof(double) + sizeof(quint32)), Qt::Uninitialized);
+    uchar *values = reinterpret_cast<uchar *>(buffer.data());
+    uchar *indices = values + count * sizeof(double);
+
+    for (int i = 0; i < count; ++i) {
+        const SignalHandle handle = handles[i];
+        qToLittleEndian(table.value(handle).toDouble(), values + i * sizeof(double));
+        qToLittleEndian(static_cast<quint32>(handle), indices + i * sizeof(quint32));
+    }
+    return QString::fromLatin1(buffer.toBase64());
 }
 
 void PlcBridge::onSignalsLoaded(int count)
 {
+    // 信号表已重建，旧句柄失效
+    m_pushTimer->stop();
+    m_pendingHandles.clear();
+    m_pendingFlags.fill(false, m_signalManager->signalTable().size());
+    resolveUrgentSignals();
+
+    if (m_compactPush) {
+        emit signalSchemaChanged(getSignalSchema());
+    }
     emit signalsConfigChanged(count);
 }
 
@@ -5,10 +5,15 @@
 #include <QVariantList>
 #include <QVariantMap>
 #include <QTimer>
+#include <QVector>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QFuture>
+#include "../modbus/SignalManager.h"
 
 class ModbusManager;
-class SignalManager;
 class ConfigManager;
+class PollScheduler;
 
 /**
  * @file PlcBridge.h
@@ -33,8 +38,9 @@ public:
 
 public slots:
     // ========== 原有接口 ==========
-    QVariantList readData(int address, int count);
-    bool writeData(int address, const QVariantList &values);
+    // 访问总线的接口均返回 Future，不阻塞 GUI 线程，结果以 Promise 形式返回前端
+    QFuture<QVariant> readData(int address, int count);
+    QFuture<QVariant> writeData(int address, const QVariantList &values);
 
     // ========== 信号配置接口 ==========
     /** @brief 获取所有信号配置 */
@@ -43,14 +49,80 @@ public slots:
     /** @brief 刷新信号配置（从 ERP 同步） */
     void refreshSignals();
 
-    /** @brief 根据信号编码读取值 */
-    QVariant readBySignalCode(const QString &signalCode);
+    /**
+     * @brief 根据信号编码读取值
+     * @param maxAgeMs 轮询缓存不超过该时长时直接返回缓存，不访问总线；0 表示总是读取 PLC
+     */
+    QFuture<QVariant> readBySignalCode(const QString &signalCode, int maxAgeMs = 0);
 
     /** @brief 根据信号编码写入值 */
-    bool writeBySignalCode(const QString &signalCode, const QVariant &value);
+    QFuture<QVariant> writeBySignalCode(const QString &signalCode, const QVariant &value);
 
-    /** @brief 批量读取信号值 */
-    QVariantMap batchRead(const QStringList &signalCodes);
+    /**
+     * @brief 批量写入信号值，相邻寄存器合并为尽量少的写入请求
+     * @param values {signalCode: value}
+     * @return 各信号是否写入成功 {signalCode: bool}
+     */
+    QFuture<QVariant> writeSignalValues(const QVariantMap &values);
+
+    /**
+     * @brief 批量读取参数组别的配方快照（总是访问总线）
+     * @return {paramGroup, values: {signalCode: value}, failedCodes: [signalCode]}
+     */
+    QFuture<QVariant> readGroupSnapshot(const QString &paramGroup);
+
+    /**
+     * @brief 按差异下载配方：只写入与 PLC 当前值不同的信号，并批量回读校验
+     * @return {success, written, unchanged, failed, mismatched}
+     */
+    QFuture<QVariant> downloadRecipe(const QString &paramGroup, const QVariantMap &values);
+
+    /** @brief 批量读取信号值，maxAgeMs 同 readBySignalCode */
+    QFuture<QVariant> batchRead(const QStringList &signalCodes, int maxAgeMs = 0);
+
+    /**
+     * @brief 读取缓存的信号值及质量，不访问总线
+     * @return {signalCode: {value, quality: "good" | "stale" | "commError", ageMs}}
+     */
+    QVariantMap readCachedSignals(const QStringList &signalCodes);
+
+    /**
+     * @brief 获取当前全部信号值快照，用于前端版本号不连续时重新同步
+     * @return {version: 当前推送版本号, values: {signalCode: value}}
+     */
+    QVariantMap getSignalValues();
+
+    // ========== 紧凑推送接口 ==========
+    /**
+     * @brief 切换紧凑推送格式
+     * @description 开启后改为发射 signalValuesPacked：按信号索引打包的二进制数据（base64），
+     *              索引与编码的对应关系见 getSignalSchema；类型为 int64 的信号无法用 Float64 精确表示，
+     *              不打包，仍通过 signalValuesChanged 以增量推送
+     */
+    void setCompactPush(bool enabled);
+
+    /**
+     * @brief 获取紧凑推送的信号索引表
+     * @return {schemaVersion: 索引表版本, codes: [索引 -> signalCode], types: [索引 -> "bool" | "number" | "int64"]}，
+     *         int64 信号不出现在紧凑推送中
+     */
+    QVariantMap getSignalSchema();
+
+    // ========== 推送限速接口 ==========
+    /**
+     * @brief 设置界面刷新频率上限
+     * @description 与 PLC 轮询频率无关：两帧之间的变化合并为一次推送，推送的是合并时刻的最新值
+     * @param hz 每秒最多推送次数（1~60），默认 25
+     */
+    void setUiRefreshRate(int hz);
+
+    /**
+     * @brief 设置紧急信号
+     * @description 紧急信号（报警、握手位等）变化时立即推送，不等待下一帧，
+     *              同一帧内已合并的其他变化一并推送
+     * @param signalCodes 信号编码列表
+     */
+    void setUrgentSignals(const QStringList &signalCodes);
 
     // ========== 设备配置接口 ==========
     /** @brief 获取当前设备配置 */
@@ -60,12 +132,52 @@ public slots:
     void initWithToken(const QString &token);
 
     // ========== 轮询控制 ==========
-    /** @brief 启动数据轮询 */
+    /** @brief 启动数据轮询，intervalMs 为常规等级的轮询周期 */
     void startPolling(int intervalMs = 100);
 
     /** @brief 停止数据轮询 */
     void stopPolling();
 
+    /**
+     * @brief 设置轮询等级的周期
+     * @param pollClass 轮询等级：fast（默认 50ms）、normal（startPolling 指定）、slow（默认 5s）
+     */
+    void setPollClassInterval(const QString &pollClass, int intervalMs);
+
+    /**
+     * @brief 设置参数组别的轮询等级，未设置的组别按 normal 轮询
+     */
+    void setGroupPollClass(const QString &paramGroup, const QString &pollClass);
+
+    /**
+     * @brief 获取轮询周期统计
+     * @return {running, cycleCount, overrunCount, skippedCycles,
+     *          groups: {fast | normal | slow: {intervalMs, cycleCount, overrunCount, skippedCycles,
+     *                   lastDurationMs, avgDurationMs, minDurationMs, maxDurationMs,
+     *                   lastJitterMs, avgJitterMs, maxJitterMs}},
+     *          link: {srttMs, rttVarMs, timeoutMs, samples, timeouts, retries, linkDowns}}，
+     *          轮询统计在每次启动轮询时清零，link 为累计的链路时延统计
+     */
+    QVariantMap getPollStats();
+
+    /**
+     * @brief 获取因地址被 PLC 拒绝而停止读取的信号编码
+     * @description 批量读取收到异常响应时自动二分定位，隔离状态在信号配置重新加载后清除
+     */
+    QStringList getQuarantinedSignals();
+
+    // ========== 订阅接口 ==========
+    /**
+     * @brief 订阅信号，轮询只读取被订阅的信号
+     * @param signalCodes 信号编码列表
+     * @param paramGroups 参数组别列表（组内全部信号）
+     * @return 订阅 ID，视图卸载时传给 unsubscribe
+     */
+    int subscribe(const QStringList &signalCodes, const QStringList &paramGroups);
+
+    /** @brief 取消订阅 */
+    void unsubscribe(int subscriptionId);
+
     // ========== 日志接口 ==========
     /** @brief 获取日志文件列表（最近 N 天） */
     QVariantList getLogFiles(int days = 3);
@@ -76,23 +188,79 @@ public slots:
 signals:
     void connectionChanged(bool connected);
     void dataReceived(const QVariantMap &data);
-    void signalValuesChanged(const QVariantMap &values);
+    /**
+     * @brief 信号值推送
+     * @param values 增量推送时只包含变化的信号，全量同步时包含全部信号
+     * @param version 推送版本号，每次推送递增，前端据此检测丢失的增量
+     * @param fullSync 是否为全量同步
+     */
+    void signalValuesChanged(const QVariantMap &values, int version, bool fullSync);
+
+    /**
+     * @brief 紧凑格式的信号值推送
+     * @param packed base64 编码的数据：n 个 Float64 值在前，n 个 Uint32 索引在后（小端）
+     * @param schemaVersion 索引表版本，与 getSignalSchema 不一致时需重新获取索引表
+     * @param version 推送版本号，与 signalValuesChanged 共用
+     * @param fullSync 是否为全量同步
+     */
+    void signalValuesPacked(const QString &packed, int schemaVersion, int version, bool fullSync);
+
+    /** @brief 信号索引表变化（信号配置重新加载） */
+    void signalSchemaChanged(const QVariantMap &schema);
     void signalsConfigChanged(int count);
     void pollingChanged(bool polling);
     void errorOccurred(const QString &error);
 
 private slots:
-    void onPollTimer();
+    void onSignalValuesChanged(const QVector<int> &handles);
+    void onFullSyncTimer();
+    void onPushTimer();
     void onSignalsLoaded(int count);
     void onSyncCompleted(bool success, int count);
 
 private:
+    /** @brief 执行指定轮询等级的一个周期，未连接时返回已完成的空 Future */
+    QFuture<int> pollCycle(SignalManager::PollClass pollClass);
+
+    /** @brief 按当前格式推送指定句柄的信号值 */
+    void pushValues(const QVector<int> &handles, bool fullSync);
+
+    /** @brief 打包信号值为紧凑格式 */
+    QString packValues(const QVector<int> &handles) const;
+
+    /** @brief 推送所有待推送的变化 */
+    void flushPendingValues();
+
+    /** @brief 丢弃待推送的变化（句柄随信号表重建失效） */
+    void clearPendingValues();
+
+    /** @brief 按当前信号表解析紧急信号句柄 */
+    void resolveUrgentSignals();
+
     ModbusManager *m_modbusManager;
     SignalManager *m_signalManager;
     ConfigManager *m_configManager;
-    QTimer *m_pollTimer;
+    PollScheduler *m_pollScheduler;
+    QTimer *m_fullSyncTimer;   // 周期性全量同步定时器
     bool m_isPolling;
-    QVariantMap m_lastValues;  // 上次读取的值，用于变化检测
+    int m_valueVersion;        // 信号值推送版本号
+    bool m_compactPush;        // 是否使用紧凑推送格式
+
+    // 推送限速
+    QTimer *m_pushTimer;                // 下一帧推送定时器
+    QElapsedTimer m_lastPushClock;      // 上次推送时刻
+    int m_pushIntervalMs;               // 最小推送间隔
+    QVector<int> m_pendingHandles;      // 待推送的信号句柄
+    QVector<bool> m_pendingFlags;       // 句柄是否已在待推送列表中
+    QSet<QString> m_urgentCodes;        // 紧急信号编码
+    QVector<bool> m_urgentFlags;        // 句柄是否为紧急信号
+
+    static constexpr int DefaultUiRefreshHz = 25;     // 默认界面刷新频率
+
+    static constexpr int FullSyncIntervalMs = 10000;  // 全量同步间隔
+
+    /** 各轮询等级的默认周期（fast / normal / slow） */
+    static constexpr int DefaultPollIntervals[SignalManager::PollClassCount] = {50, 100, 5000};
 };
 
 #endif // PLCBRIDGE_H
@@ -33,6 +33,30 @@ struct DeviceConfig
     /** 连接超时时间(毫秒) */
     int timeout = 3000;
 
+    /** 同时在途的最大 Modbus 请求数（流水线窗口） */
+    int maxInFlight = 4;
+
+    /** 每个轮询周期允许的超时重发次数 */
+    int retryBudget = 2;
+
+    /** 链路空闲时的心跳探测间隔(毫秒)，0 表示关闭 */
+    int heartbeatInterval = 1000;
+
+    /** 心跳探测读取的保持寄存器地址 */
+    int heartbeatAddress = 0;
+
+    /** Modbus 通信后端："qt"（QModbusTcpClient）或 "native"（自有 TCP 编解码） */
+    QString modbusBackend = QStringLiteral("qt");
+
+    /** 快速轮询等级的周期(毫秒) */
+    int fastPollInterval = 50;
+
+    /** 慢速轮询等级的周期(毫秒) */
+    int slowPollInterval = 5000;
+
+    /** 参数组别的轮询等级 {paramGroup: "fast" | "normal" | "slow"}，未列出的组别按 normal 轮询 */
+    QVariantMap pollClasses;
+
     /** 设备状态（0正常 1停用） */
     QString status;
 
@@ -70,6 +94,14 @@ struct DeviceConfig
         config.port = json.value("port", 502).toInt();
         config.slaveId = json.value("slaveId", 1).toInt();
         config.timeout = json.value("timeout", 3000).toInt();
+        config.maxInFlight = json.value("maxInFlight", 4).toInt();
+        config.retryBudget = json.value("retryBudget", 2).toInt();
+        config.heartbeatInterval = json.value("heartbeatInterval", 1000).toInt();
+        config.heartbeatAddress = json.value("heartbeatAddress", 0).toInt();
+        config.modbusBackend = json.value("modbusBackend", QStringLiteral("qt")).toString();
+        config.fastPollInterval = json.value("fastPollInterval", 50).toInt();
+        config.slowPollInterval = json.value("slowPollInterval", 5000).toInt();
+        config.pollClasses = json.value("pollClasses").toMap();
         config.status = json.value("status").toString();
         config.processorType = json.value("processorType").toString();
         config.operationIp = json.value("operationIp").toString();
@@ -90,6 +122,14 @@ struct DeviceConfig
         map["port"] = port;
         map["slaveId"] = slaveId;
         map["timeout"] = timeout;
+        map["maxInFlight"] = maxInFlight;
+        map["retryBudget"] = retryBudget;
+        map["heartbeatInterval"] = heartbeatInterval;
+        map["heartbeatAddress"] = heartbeatAddress;
+        map["modbusBackend"] = modbusBackend;
+        map["fastPollInterval"] = fastPollInterval;
+        map["slowPollInterval"] = slowPollInterval;
+        map["pollClasses"] = pollClasses;
         map["status"] = status;
         map["processorType"] = processorType;
         map["operationIp"] = operationIp;
@@ -17,7 +17,8 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_webView(new QWebEngineView(this))
     , m_webChannel(new QWebChannel(this))
-    , m_modbusManager(new ModbusManager(this))
+    , m_modbusThread(new QThread(this))
+    , m_modbusManager(new ModbusManager)
     , m_addressMapper(new PlcAddressMapper(this))
     , m_signalManager(new SignalManager(m_modbusManager, m_addressMapper, this))
     , m_configManager(new ConfigManager(m_signalManager, this))
@@ -28,6 +29,13 @@ MainWindow::MainWindow(QWidget *parent)
 {
     setWindowTitle("SamPress QT");
 
+    // Modbus 通信运行在独立线程，避免与 WebEngine IPC、日志写入、ERP 请求争用界面事件循环
+    m_modbusThread->setObjectName("ModbusIO");
+    m_modbusManager->moveToThread(m_modbusThread);
+    connect(m_modbusThread, &QThread::finished,
+            m_modbusManager, &QObject::deleteLater);
+    m_modbusThread->start(QThread::HighPriority);
+
     // 设置窗口最小尺寸限制（适配 10 英寸工控机触屏）
     setMinimumSize(1024, 768);
     resize(1024, 768);
@@ -49,6 +57,9 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // 停止 Modbus I/O 线程，线程结束时自动释放 ModbusManager
+    m_modbusThread->quit();
+    m_modbusThread->wait();
 }
 
 void MainWindow::setupWebEngine()
@@ -88,6 +99,15 @@ void MainWindow::setupWebChannel()
 
 void MainWindow::onDeviceConfigLoaded(const DeviceConfig &config)
 {
+    // 请求超时上限、流水线窗口与重试预算
+    m_modbusManager->setRequestTimeout(config.timeout);
+    m_modbusManager->setMaxInFlight(config.maxInFlight);
+    m_modbusManager->setRetryBudget(config.retryBudget);
+    m_modbusManager->setHeartbeat(config.heartbeatInterval, config.heartbeatAddress);
+    m_modbusManager->setBackend(config.modbusBackend == QLatin1String("native")
+                                    ? ModbusManager::NativeTcpBackend
+                                    : ModbusManager::QtModbusBackend);
+
     // 连接 PLC 设备
     m_modbusManager->connectToDevice(
         config.ipAddress,
@@ -95,9 +115,14 @@ void MainWindow::onDeviceConfigLoaded(const DeviceConfig &config)
         config.slaveId
     );
 
-    // 设置连接超时
+    // 断线自动重连：立即重试一次，之后退避，最长间隔 5 秒
     m_modbusManager->setAutoReconnect(true, 5000);
 
+    // 多速率轮询：参数组别的轮询等级与快/慢等级周期
+    m_signalManager->setGroupPollClasses(config.pollClasses);
+    m_plcBridge->setPollClassInterval(QStringLiteral("fast"), config.fastPollInterval);
+    m_plcBridge->setPollClassInterval(QStringLiteral("slow"), config.slowPollInterval);
+
     // 初始化信号配置
     m_configManager->initialize(m_erpBaseUrl, config.deviceId);
 }
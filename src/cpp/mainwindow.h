@@ -4,6 +4,7 @@
 #include <QMainWindow>
 #include <QWebEngineView>
 #include <QWebChannel>
+#include <QThread>
 #include "config/DeviceConfig.h"
 
 class PlcBridge;
@@ -32,7 +33,8 @@ private:
 
     QWebEngineView *m_webView;
     QWebChannel *m_webChannel;
-    ModbusManager *m_modbusManager;
+    QThread *m_modbusThread;          // Modbus I/O 线程
+    ModbusManager *m_modbusManager;   // 运行在 m_modbusThread 中
     PlcAddressMapper *m_addressMapper;
     SignalManager *m_signalManager;
     ConfigManager *m_configManager;
@@ -0,0 +1,75 @@
+#include "BatchReadPlanner.h"
+#include <algorithm>
+
+/**
+ * @file BatchReadPlanner.cpp
+ * @brief 批量读取规划器实现
+ */
+
+int BatchReadPlanner::maxCountPerRead(ModbusManager::RegisterType type)
+{
+    if (type == ModbusManager::Coils || type == ModbusManager::DiscreteInputs) {
+        return MaxCoilsPerRead;
+    }
+    return MaxRegistersPerRead;
+}
+
+QVector<ReadBlock> BatchReadPlanner::plan(QVector<ReadItem> items, int gapTolerance)
+{
+    QVector<ReadBlock> blocks;
+    if (items.isEmpty()) {
+        return blocks;
+    }
+
+    // 按寄存器类型、地址排序，相同地址时长度大的在前
+    std::sort(items.begin(), items.end(), [](const ReadItem &a, const ReadItem &b) {
+        if (a.registerType != b.registerType) {
+            return a.registerType < b.registerType;
+        }
+        if (a.address != b.address) {
+            return a.address < b.address;
+        }
+        return a.count > b.count;
+    });
+
+    gapTolerance = qMax(0, gapTolerance);
+
+    ReadBlock current;
+    int currentEnd = 0;  // 当前块结束地址（不含）
+
+    for (const ReadItem &item : items) {
+        const int itemEnd = item.address + qMax(1, item.count);
+        const int limit = maxCountPerRead(item.registerType);
+        const bool isBit = item.registerType == ModbusManager::Coils
+                        || item.registerType == ModbusManager::DiscreteInputs;
+        const int gap = isBit ? gapTolerance * CoilsPerRegister : gapTolerance;
+
+        // 同类型、间隙在容差内且合并后不超过 PDU 限制时并入当前块
+        const bool canMerge = !current.members.isEmpty()
+            && item.registerType == current.registerType
+            && item.address - currentEnd <= gap
+            && qMax(currentEnd, itemEnd) - current.startAddress <= limit;
+
+        if (canMerge) {
+            currentEnd = qMax(currentEnd, itemEnd);
+            current.count = currentEnd - current.startAddress;
+            current.members.append(item);
+            continue;
+        }
+
+        if (!current.members.isEmpty()) {
+            blocks.append(current);
+        }
+        current = ReadBlock();
+        current.registerType = item.registerType;
+        current.startAddress = item.address;
+        currentEnd = itemEnd;
+        current.count = currentEnd - current.startAddress;
+        current.members.append(item);
+    }
+
+    if (!current.members.isEmpty()) {
+        blocks.append(current);
+    }
+    return blocks;
+}
@@ -0,0 +1,63 @@
+#ifndef BATCHREADPLANNER_H
+#define BATCHREADPLANNER_H
+
+#include <QVector>
+#include "ModbusManager.h"
+
+/**
+ * @file BatchReadPlanner.h
+ * @brief 批量读取规划器
+ * @description 将离散的信号读取按寄存器类型和地址排序，合并为尽量少的 FC01/FC03 批量请求
+ */
+
+/**
+ * @brief 待规划的读取项
+ */
+struct ReadItem {
+    ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;  // 寄存器类型
+    int address = 0;            // 起始地址
+    int count = 1;              // 寄存器/线圈数量
+    int index = 0;              // 调用方的信号索引
+};
+
+/**
+ * @brief 合并后的批量读取块
+ */
+struct ReadBlock {
+    ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;  // 寄存器类型
+    int startAddress = 0;       // 块起始地址
+    int count = 0;              // 块长度
+    QVector<ReadItem> members;  // 块内的读取项，按地址升序
+
+    /** @brief 读取项在块响应数据中的偏移 */
+    int offsetOf(const ReadItem &item) const { return item.address - startAddress; }
+};
+
+class BatchReadPlanner
+{
+public:
+    /** 单次 FC03 读取的最大寄存器数（Modbus PDU 限制） */
+    static constexpr int MaxRegistersPerRead = 125;
+
+    /** 单次 FC01 读取的最大线圈数（Modbus PDU 限制） */
+    static constexpr int MaxCoilsPerRead = 2000;
+
+    /** 线圈与寄存器的间隙换算：16 个线圈占用与 1 个寄存器相同的报文字节 */
+    static constexpr int CoilsPerRegister = 16;
+
+    /**
+     * @brief 生成批量读取计划
+     * @param items 待读取项
+     * @param gapTolerance 允许合并的地址间隙（寄存器数），间隙内的多余数据随块一起读回丢弃；
+     *                     线圈按 gapTolerance * CoilsPerRegister 计算
+     * @return 读取块列表，按寄存器类型和地址升序
+     */
+    static QVector<ReadBlock> plan(QVector<ReadItem> items, int gapTolerance);
+
+    /**
+     * @brief 获取寄存器类型对应的单次读取上限
+     */
+    static int maxCountPerRead(ModbusManager::RegisterType type);
+};
+
+#endif // BATCHREADPLANNER_H
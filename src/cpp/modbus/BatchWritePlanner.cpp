@@ -0,0 +1,55 @@
+#include "BatchWritePlanner.h"
+#include <algorithm>
+
+/**
+ * @file BatchWritePlanner.cpp
+ * @brief 批量写入规划器实现
+ */
+
+int BatchWritePlanner::maxCountPerWrite(ModbusManager::RegisterType type)
+{
+    if (type == ModbusManager::Coils) {
+        return MaxCoilsPerWrite;
+    }
+    return MaxRegistersPerWrite;
+}
+
+QVector<WriteBlock> BatchWritePlanner::plan(QVector<WriteItem> items)
+{
+    QVector<WriteBlock> blocks;
+
+    // 按寄存器类型、地址排序，相同地址保持调用方顺序
+    std::stable_sort(items.begin(), items.end(), [](const WriteItem &a, const WriteItem &b) {
+        if (a.registerType != b.registerType) {
+            return a.registerType < b.registerType;
+        }
+        return a.address < b.address;
+    });
+
+    for (const WriteItem &item : items) {
+        if (item.values.isEmpty()) {
+            continue;
+        }
+
+        // 同类型、紧接上一块末尾且合并后不超过 PDU 限制时并入上一块
+        if (!blocks.isEmpty()) {
+            WriteBlock &last = blocks.last();
+            const bool canMerge = item.registerType == last.registerType
+                && item.address == last.startAddress + last.values.size()
+                && last.values.size() + item.values.size() <= maxCountPerWrite(item.registerType);
+            if (canMerge) {
+                last.values += item.values;
+                last.members.append(item.index);
+                continue;
+            }
+        }
+
+        WriteBlock block;
+        block.registerType = item.registerType;
+        block.startAddress = item.address;
+        block.values = item.values;
+        block.members.append(item.index);
+        blocks.append(block);
+    }
+    return blocks;
+}
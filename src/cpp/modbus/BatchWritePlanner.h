@@ -0,0 +1,56 @@
+#ifndef BATCHWRITEPLANNER_H
+#define BATCHWRITEPLANNER_H
+
+#include <QVector>
+#include "ModbusManager.h"
+
+/**
+ * @file BatchWritePlanner.h
+ * @brief 批量写入规划器
+ * @description 将多个信号的写入按寄存器类型和地址排序，地址首尾相接的写入合并为尽量少的
+ *              FC16/FC15 请求。与读取不同，写入不能跨越间隙，否则会覆盖间隙内的寄存器
+ */
+
+/**
+ * @brief 待规划的写入项
+ */
+struct WriteItem {
+    ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;  // 寄存器类型
+    int address = 0;            // 起始地址
+    QVector<quint16> values;    // 编码后的寄存器值，线圈为 0/1
+    int index = 0;              // 调用方的写入项索引
+};
+
+/**
+ * @brief 合并后的批量写入块
+ */
+struct WriteBlock {
+    ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;  // 寄存器类型
+    int startAddress = 0;       // 块起始地址
+    QVector<quint16> values;    // 块数据
+    QVector<int> members;       // 块内写入项的 index，按地址升序
+};
+
+class BatchWritePlanner
+{
+public:
+    /** 单次 FC16 写入的最大寄存器数（Modbus PDU 限制） */
+    static constexpr int MaxRegistersPerWrite = 123;
+
+    /** 单次 FC15 写入的最大线圈数（Modbus PDU 限制） */
+    static constexpr int MaxCoilsPerWrite = 1968;
+
+    /**
+     * @brief 生成批量写入计划
+     * @description 相同地址的写入不合并，按调用方顺序落在不同的块中
+     * @return 写入块列表，按寄存器类型和地址升序
+     */
+    static QVector<WriteBlock> plan(QVector<WriteItem> items);
+
+    /**
+     * @brief 获取寄存器类型对应的单次写入上限
+     */
+    static int maxCountPerWrite(ModbusManager::RegisterType type);
+};
+
+#endif // BATCHWRITEPLANNER_H
@@ -0,0 +1,194 @@
+#include "BulkDecoder.h"
+#include <QtEndian>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BULKDECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file BulkDecoder.cpp
+ * @brief 批量解码器实现
+ */
+
+namespace {
+void appendWords(QVector<quint16> &words, const quint16 *raw, int count)
+{
+    const int offset = words.size();
+    words.resize(offset + count);
+    std::memcpy(words.data() + offset, raw, count * sizeof(quint16));
+}
+}
+
+void BulkDecoder::assembleFloat32(const quint16 *words, int count, float *out)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    // 小端主机上低位字在前的字对与 float 的内存布局相同，整段复制即可
+    if (count > 0) {
+        std::memcpy(out, words, count * sizeof(float));
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        const quint32 combined = (static_cast<quint32>(words[2 * i + 1]) << 16) | words[2 * i];
+        std::memcpy(out + i, &combined, sizeof(float));
+    }
+#endif
+}
+
+void BulkDecoder::assemble64(const quint16 *words, int count, quint64 *out)
+{
+    int i = 0;
+#ifdef BULKDECODER_SSE2
+    // 每次处理两个值：组内 4 个字倒序后即为小端 64 位整数
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words + 4 * i));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), v);
+    }
+#endif
+    for (; i < count; ++i) {
+        const quint16 *raw = words + 4 * i;
+        out[i] = (static_cast<quint64>(raw[0]) << 48) |
+                 (static_cast<quint64>(raw[1]) << 32) |
+                 (static_cast<quint64>(raw[2]) << 16) |
+                 static_cast<quint64>(raw[3]);
+    }
+}
+
+void BulkDecoder::scaleUInt16(const quint16 *words, const double *divisors, int count, double *out)
+{
+    int i = 0;
+#ifdef BULKDECODER_SSE2
+    // 每次处理 8 个值：零扩展为 32 位整数后转换为 double 再相除，与标量除法结果一致
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words + i));
+        const __m128i lo = _mm_unpacklo_epi16(v, zero);
+        const __m128i hi = _mm_unpackhi_epi16(v, zero);
+        _mm_storeu_pd(out + i, _mm_div_pd(_mm_cvtepi32_pd(lo), _mm_loadu_pd(divisors + i)));
+        _mm_storeu_pd(out + i + 2, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(lo, 8)),
+                                              _mm_loadu_pd(divisors + i + 2)));
+        _mm_storeu_pd(out + i + 4, _mm_div_pd(_mm_cvtepi32_pd(hi), _mm_loadu_pd(divisors + i + 4)));
+        _mm_storeu_pd(out + i + 6, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(hi, 8)),
+                                              _mm_loadu_pd(divisors + i + 6)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = words[i] / divisors[i];
+    }
+}
+
+void BulkDecoder::extractBits(const quint16 *words, int count, quint8 *out)
+{
+    int i = 0;
+#ifdef BULKDECODER_SSE2
+    // 每次处理 8 个值：等于零的字比较结果为 -1，压缩为字节后加 1 即得 0/1
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words + i));
+        const __m128i isZero = _mm_packs_epi16(_mm_cmpeq_epi16(v, zero), zero);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_add_epi8(isZero, one));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = words[i] != 0 ? 1 : 0;
+    }
+}
+
+void BulkDecoder::decode(const SignalTable &table, const RegisterImage &image,
+                         const QVector<SignalHandle> &handles, QVector<QVariant> &values)
+{
+    values.resize(handles.size());
+    m_bits.clear();
+    m_scaled.clear();
+    m_floats.clear();
+    m_doubles.clear();
+    m_longs.clear();
+    m_divisors.clear();
+
+    // 按解码类型收集原始寄存器；单寄存器整数与其他类型直接解码
+    for (int i = 0; i < handles.size(); ++i) {
+        const SignalHandle handle = handles[i];
+        const quint16 *raw = image.signalData(table, handle);
+        if (!raw) {
+            values[i] = QVariant();
+            continue;
+        }
+
+        switch (table.decodeKind(handle)) {
+        case DecodeKind::Bit:
+            m_bits.positions.append(i);
+            m_bits.words.append(raw[0]);
+            break;
+        case DecodeKind::BitInWord:
+            // 先屏蔽其余位，与线圈共用位提取
+            m_bits.positions.append(i);
+            m_bits.words.append(static_cast<quint16>(raw[0] & (1u << table.bitIndex(handle))));
+            break;
+        case DecodeKind::UInt16:
+            values[i] = static_cast<int>(raw[0]);
+            break;
+        case DecodeKind::UInt16Scaled:
+            m_scaled.positions.append(i);
+            m_scaled.words.append(raw[0]);
+            m_divisors.append(table.scaleDivisor(handle));
+            break;
+        case DecodeKind::Float32:
+            m_floats.positions.append(i);
+            appendWords(m_floats.words, raw, 2);
+            break;
+        case DecodeKind::Float64:
+            m_doubles.positions.append(i);
+            appendWords(m_doubles.words, raw, 4);
+            break;
+        case DecodeKind::Int64:
+            m_longs.positions.append(i);
+            appendWords(m_longs.words, raw, 4);
+            break;
+        case DecodeKind::Raw:
+            values[i] = table.decode(handle, raw, table.registerCount(handle));
+            break;
+        }
+    }
+
+    // 每种类型一次批量转换，再按原位置生成信号值
+    const int bitCount = m_bits.positions.size();
+    m_bitOut.resize(bitCount);
+    extractBits(m_bits.words.constData(), bitCount, m_bitOut.data());
+    for (int k = 0; k < bitCount; ++k) {
+        values[m_bits.positions[k]] = m_bitOut[k] != 0;
+    }
+
+    const int scaledCount = m_scaled.positions.size();
+    m_doubleOut.resize(scaledCount);
+    scaleUInt16(m_scaled.words.constData(), m_divisors.constData(), scaledCount, m_doubleOut.data());
+    for (int k = 0; k < scaledCount; ++k) {
+        values[m_scaled.positions[k]] = m_doubleOut[k];
+    }
+
+    const int floatCount = m_floats.positions.size();
+    m_floatOut.resize(floatCount);
+    assembleFloat32(m_floats.words.constData(), floatCount, m_floatOut.data());
+    for (int k = 0; k < floatCount; ++k) {
+        values[m_floats.positions[k]] = static_cast<double>(m_floatOut[k]);
+    }
+
+    const int doubleCount = m_doubles.positions.size();
+    m_longOut.resize(doubleCount);
+    assemble64(m_doubles.words.constData(), doubleCount, m_longOut.data());
+    for (int k = 0; k < doubleCount; ++k) {
+        double doubleVal;
+        std::memcpy(&doubleVal, &m_longOut[k], sizeof(double));
+        values[m_doubles.positions[k]] = doubleVal;
+    }
+
+    const int longCount = m_longs.positions.size();
+    m_longOut.resize(longCount);
+    assemble64(m_longs.words.constData(), longCount, m_longOut.data());
+    for (int k = 0; k < longCount; ++k) {
+        values[m_longs.positions[k]] = static_cast<qint64>(m_longOut[k]);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef BULKDECODER_H
+#define BULKDECODER_H
+
+#include <QVector>
+#include <QVariant>
+#include "SignalTable.h"
+#include "RegisterImage.h"
+
+/**
+ * @file BulkDecoder.h
+ * @brief 批量解码器
+ * @description 将一轮需要解码的信号按解码类型分组，先把各组的原始寄存器收集到连续缓冲区，
+ *              再由批量转换核函数一次处理整组，最后按原顺序生成信号值。
+ *              核函数在支持 SSE2 的平台上使用向量指令，其他平台使用等价的标量实现，
+ *              结果与 SignalCodec::decode 逐个解码完全一致。
+ */
+
+class BulkDecoder
+{
+public:
+    /**
+     * @brief 从寄存器影像批量解码信号
+     * @param handles 需要解码的信号句柄
+     * @param values 输出，与 handles 一一对应；信号未纳入影像时为无效 QVariant
+     */
+    void decode(const SignalTable &table, const RegisterImage &image,
+                const QVector<SignalHandle> &handles, QVector<QVariant> &values);
+
+    // ========== 批量转换核函数 ==========
+
+    /**
+     * @brief 低位字在前的双寄存器浮点数
+     * @param words count 个字对 [低位字, 高位字]
+     */
+    static void assembleFloat32(const quint16 *words, int count, float *out);
+
+    /**
+     * @brief 高位字在前的四寄存器 64 位数据（double/int64 的原始位）
+     * @param words count 组 [raw0, raw1, raw2, raw3]，raw0 为最高位字
+     */
+    static void assemble64(const quint16 *words, int count, quint64 *out);
+
+    /**
+     * @brief 单寄存器无符号整数按 10^n 缩放
+     * @param divisors 每个值对应的 10^scaleFactor
+     */
+    static void scaleUInt16(const quint16 *words, const double *divisors, int count, double *out);
+
+    /**
+     * @brief 位提取：寄存器值非零为 1，否则为 0
+     */
+    static void extractBits(const quint16 *words, int count, quint8 *out);
+
+private:
+    /**
+     * @brief 同一解码类型的待解码信号
+     */
+    struct Lane {
+        QVector<int> positions;     // 在输出中的位置
+        QVector<quint16> words;     // 连续存放的原始寄存器
+
+        void clear()
+        {
+            positions.clear();
+            words.clear();
+        }
+    };
+
+    // 缓冲区在多轮解码间复用，稳定运行后不再分配内存
+    Lane m_bits;
+    Lane m_scaled;
+    Lane m_floats;
+    Lane m_doubles;
+    Lane m_longs;
+    QVector<double> m_divisors;
+    QVector<quint8> m_bitOut;
+    QVector<double> m_doubleOut;
+    QVector<float> m_floatOut;
+    QVector<quint64> m_longOut;
+};
+
+#endif // BULKDECODER_H
@@ -1,234 +1,930 @@
 #include "ModbusManager.h"
 #include <QModbusDataUnit>
-#include <QCoreApplication>
+#include <QPromise>
+#include <QRandomGenerator>
+#include <cmath>
 
 /**
  * @file ModbusManager.cpp
  * @brief Modbus TCP 通信管理器实现
  */
 
+namespace {
+/**
+ * @brief 一次性的 Future 接收方：请求完成时转换结果、结束 Future 并释放自身
+ * @description 仅用于按需的 QFuture 接口；周期性轮询使用调用方预先分配的接收方
+ */
+template <typename T, typename Convert>
+class PromiseSink : public ModbusManager::ResultSink
+{
+public:
+    explicit PromiseSink(Convert convert) : m_convert(std::move(convert)) { m_promise.start(); }
+
+    QFuture<T> future() { return m_promise.future(); }
+
+    void complete(int, bool success, const quint16 *values, int count, int exceptionCode) override
+    {
+        m_promise.addResult(m_convert(success, values, count, exceptionCode));
+        m_promise.finish();
+        delete this;
+    }
+
+private:
+    QPromise<T> m_promise;
+    Convert m_convert;
+};
+
+template <typename T, typename Convert>
+PromiseSink<T, Convert> *makePromiseSink(Convert convert)
+{
+    return new PromiseSink<T, Convert>(std::move(convert));
+}
+
+QModbusDataUnit::RegisterType unitTypeOf(ModbusManager::RegisterType type)
+{
+    switch (type) {
+    case ModbusManager::Coils:
+        return QModbusDataUnit::Coils;
+    case ModbusManager::DiscreteInputs:
+        return QModbusDataUnit::DiscreteInputs;
+    case ModbusManager::InputRegisters:
+        return QModbusDataUnit::InputRegisters;
+    case ModbusManager::HoldingRegisters:
+        break;
+    }
+    return QModbusDataUnit::HoldingRegisters;
+}
+
+/** 响应为 Modbus 异常时返回异常码，其他情况返回 0 */
+int exceptionCodeOf(const QModbusReply *reply)
+{
+    if (reply->error() != QModbusDevice::ProtocolError) {
+        return 0;
+    }
+    const QModbusResponse response = reply->rawResult();
+    return response.isException() ? static_cast<int>(response.exceptionCode()) : 0;
+}
+}
+
 ModbusManager::ModbusManager(QObject *parent)
     : QObject(parent)
     , m_modbusClient(new QModbusTcpClient(this))
+    , m_tcpTransport(new ModbusTcpTransport(this))
+    , m_backend(QtModbusBackend)
+    , m_activeBackend(QtModbusBackend)
     , m_slaveId(1)
+    , m_connected(false)
     , m_port(502)
+    , m_dispatchPending(false)
+    , m_maxInFlight(4)
+    , m_requestTimeout(3000)
+    , m_inFlight(0)
+    , m_hasRttSample(false)
+    , m_srttMs(0.0)
+    , m_rttVarMs(0.0)
+    , m_timeoutMs(0)
+    , m_rttSamples(0)
+    , m_timeoutCount(0)
+    , m_retryCount(0)
+    , m_linkDownCount(0)
+    , m_retryBudget(2)
+    , m_retryTokens(2)
+    , m_heartbeatTimer(new QTimer(this))
+    , m_heartbeatAddress(0)
+    , m_consecutiveTimeouts(0)
     , m_reconnectTimer(new QTimer(this))
     , m_autoReconnect(false)
     , m_reconnectInterval(5000)
     , m_reconnectAttempts(0)
+    , m_connectSerial(0)
 {
-    // 连接状态变化信号
-    connect(m_modbusClient, &QModbusClient::stateChanged,
-            this, &ModbusManager::onStateChanged);
-
-    // 连接错误信号
-    connect(m_modbusClient, &QModbusClient::errorOccurred,
-            this, &ModbusManager::onErrorOccurred);
-
-    // 重连定时器
+    // 连接状态与错误信号，只处理当前后端的通知
+    connect(m_modbusClient, &QModbusClient::stateChanged, this, [this](QModbusDevice::State state) {
+        if (m_activeBackend == QtModbusBackend) {
+            onStateChanged(state);
+        }
+    });
+    connect(m_modbusClient, &QModbusClient::errorOccurred, this, [this](QModbusDevice::Error error) {
+        if (m_activeBackend == QtModbusBackend) {
+            onErrorOccurred(error);
+        }
+    });
+    connect(m_tcpTransport, &ModbusTcpTransport::stateChanged, this, [this](QModbusDevice::State state) {
+        if (m_activeBackend == NativeTcpBackend) {
+            onStateChanged(state);
+        }
+    });
+    connect(m_tcpTransport, &ModbusTcpTransport::errorOccurred, this, [this](QModbusDevice::Error error) {
+        if (m_activeBackend == NativeTcpBackend) {
+            onErrorOccurred(error);
+        }
+    });
+    m_tcpTransport->setResponseHandler([this](int transactionId, ModbusTcpTransport::Status status,
+                                              int exceptionCode, const quint16 *values, int count) {
+        onNativeResponse(transactionId, status, exceptionCode, values, count);
+    });
+
+    // 重连定时器：每次按退避间隔单独安排
+    m_reconnectTimer->setSingleShot(true);
     connect(m_reconnectTimer, &QTimer::timeout,
             this, &ModbusManager::tryReconnect);
+
+    // 心跳定时器：连接建立后运行
+    m_heartbeatTimer->setInterval(1000);
+    connect(m_heartbeatTimer, &QTimer::timeout,
+            this, &ModbusManager::onHeartbeat);
 }
 
 ModbusManager::~ModbusManager()
 {
-    disconnect();
+    // 析构发生在 I/O 线程结束时，直接断开即可
+    closeTransport();
 }
 
 bool ModbusManager::connectToDevice(const QString &host, int port, int slaveId)
 {
-    // 保存连接参数（用于重连）
-    m_host = host;
-    m_port = port;
-    m_slaveId = slaveId;
-    m_reconnectAttempts = 0;
+    if (host.isEmpty()) {
+        setLastError(QStringLiteral("设备地址为空"));
+        return false;
+    }
 
-    // 设置连接参数
-    m_modbusClient->setConnectionParameter(
-        QModbusDevice::NetworkAddressParameter, host);
-    m_modbusClient->setConnectionParameter(
-        QModbusDevice::NetworkPortParameter, port);
-    m_modbusClient->setTimeout(3000);
-    m_modbusClient->setNumberOfRetries(3);
+    // 保存连接参数（用于重连）
+    {
+        QMutexLocker locker(&m_mutex);
+        m_host = host;
+        m_port = port;
+    }
+    m_slaveId.store(slaveId);
 
-    return m_modbusClient->connectDevice();
+    // 实际连接在 I/O 线程中建立
+    QMetaObject::invokeMethod(this, [this]() {
+        m_reconnectAttempts = 0;
+        openConnection();
+    }, Qt::QueuedConnection);
+    return true;
 }
 
-void ModbusManager::setAutoReconnect(bool enabled, int intervalMs)
+void ModbusManager::openConnection()
 {
-    m_autoReconnect = enabled;
-    m_reconnectInterval = intervalMs;
+    QString host;
+    int port;
+    {
+        QMutexLocker locker(&m_mutex);
+        host = m_host;
+        port = m_port;
+    }
 
-    if (!enabled && m_reconnectTimer->isActive()) {
+    // 切换后端时先断开原后端，原后端的断开通知仍按原后端处理
+    const Backend backend = static_cast<Backend>(m_backend.load());
+    if (backend != m_activeBackend) {
+        closeTransport();
         m_reconnectTimer->stop();
+        m_activeBackend = backend;
     }
+
+    if (m_activeBackend == NativeTcpBackend) {
+        m_tcpTransport->connectDevice(host, port);
+    } else {
+        // 设置连接参数
+        m_modbusClient->setConnectionParameter(
+            QModbusDevice::NetworkAddressParameter, host);
+        m_modbusClient->setConnectionParameter(
+            QModbusDevice::NetworkPortParameter, port);
+        // 客户端超时由 dispatch() 在每个请求发送前按实测时延设置，重发按重试预算控制
+        m_modbusClient->setTimeout(m_requestTimeout.load());
+        m_modbusClient->setNumberOfRetries(0);
+
+        m_modbusClient->connectDevice();
+    }
+
+    // TCP 连接建立没有超时，主机不可达时可能挂起数十秒；超过请求超时上限仍未连上则放弃本次尝试
+    const int serial = ++m_connectSerial;
+    QTimer::singleShot(m_requestTimeout.load(), this, [this, serial]() {
+        if (serial == m_connectSerial && transportState() == QModbusDevice::ConnectingState) {
+            setLastError(QStringLiteral("连接超时"));
+            closeTransport();
+        }
+    });
 }
 
-void ModbusManager::disconnect()
+QModbusDevice::State ModbusManager::transportState() const
+{
+    return m_activeBackend == NativeTcpBackend ? m_tcpTransport->state() : m_modbusClient->state();
+}
+
+QString ModbusManager::transportErrorString() const
+{
+    return m_activeBackend == NativeTcpBackend ? m_tcpTransport->errorString() : m_modbusClient->errorString();
+}
+
+void ModbusManager::closeTransport()
 {
-    if (m_modbusClient->state() != QModbusDevice::UnconnectedState) {
+    if (transportState() == QModbusDevice::UnconnectedState) {
+        return;
+    }
+    if (m_activeBackend == NativeTcpBackend) {
+        m_tcpTransport->disconnectDevice();
+    } else {
         m_modbusClient->disconnectDevice();
     }
 }
 
-bool ModbusManager::isConnected() const
+void ModbusManager::setBackend(Backend backend)
 {
-    return m_modbusClient->state() == QModbusDevice::ConnectedState;
+    m_backend.store(backend);
 }
 
-QVariantList ModbusManager::readHoldingRegisters(int address, int count)
+void ModbusManager::setAutoReconnect(bool enabled, int intervalMs)
 {
-    return readRegisters(QModbusDataUnit::HoldingRegisters, address, count);
+    QMetaObject::invokeMethod(this, [this, enabled, intervalMs]() {
+        m_autoReconnect = enabled;
+        m_reconnectInterval = intervalMs;
+
+        if (!enabled && m_reconnectTimer->isActive()) {
+            m_reconnectTimer->stop();
+        }
+    }, Qt::QueuedConnection);
 }
 
-QVariantList ModbusManager::readInputRegisters(int address, int count)
+void ModbusManager::setHeartbeat(int intervalMs, int address)
 {
-    return readRegisters(QModbusDataUnit::InputRegisters, address, count);
+    QMetaObject::invokeMethod(this, [this, intervalMs, address]() {
+        m_heartbeatAddress = address;
+        if (intervalMs <= 0) {
+            m_heartbeatTimer->stop();
+            m_heartbeatTimer->setInterval(0);
+            return;
+        }
+        m_heartbeatTimer->setInterval(intervalMs);
+        if (isConnected()) {
+            m_heartbeatTimer->start();
+        }
+    }, Qt::QueuedConnection);
 }
 
-QVariantList ModbusManager::readCoils(int address, int count)
+void ModbusManager::setMaxInFlight(int count)
 {
-    return readRegisters(QModbusDataUnit::Coils, address, count);
+    // 自有传输层的事务表按在途上限预分配，窗口不能超过事务表容量
+    m_maxInFlight.store(qBound(1, count, ModbusTcpTransport::MaxTransactions));
+
+    // 窗口扩大后立即发送排队中的请求
+    QMetaObject::invokeMethod(this, &ModbusManager::processQueue, Qt::QueuedConnection);
 }
 
-QVariantList ModbusManager::readDiscreteInputs(int address, int count)
+void ModbusManager::setRequestTimeout(int timeoutMs)
 {
-    return readRegisters(QModbusDataUnit::DiscreteInputs, address, count);
+    if (timeoutMs > 0) {
+        m_requestTimeout.store(qMax(MinTimeoutMs, timeoutMs));
+    }
 }
 
-QVariantList ModbusManager::readRegisters(QModbusDataUnit::RegisterType type, int address, int count)
+void ModbusManager::setRetryBudget(int retries)
 {
-    QVariantList result;
-    if (!isConnected()) {
-        m_lastError = QStringLiteral("未连接到设备");
-        return result;
+    m_retryBudget.store(qMax(0, retries));
+    m_retryTokens.store(qMax(0, retries));
+}
+
+QVariantMap ModbusManager::linkStats() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantMap stats;
+    stats["srttMs"] = m_srttMs;
+    stats["rttVarMs"] = m_rttVarMs;
+    stats["timeoutMs"] = m_timeoutMs > 0 ? m_timeoutMs : m_requestTimeout.load();
+    stats["samples"] = m_rttSamples;
+    stats["timeouts"] = m_timeoutCount;
+    stats["retries"] = m_retryCount;
+    stats["linkDowns"] = m_linkDownCount;
+    return stats;
+}
+
+int ModbusManager::adaptiveTimeout() const
+{
+    QMutexLocker locker(&m_mutex);
+    const int maxTimeout = m_requestTimeout.load();
+    return m_timeoutMs > 0 ? qMin(m_timeoutMs, maxTimeout) : maxTimeout;
+}
+
+void ModbusManager::recordRtt(double rttMs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // RFC 6298：首个样本初始化，之后按 1/8、1/4 的增益平滑
+    if (!m_hasRttSample) {
+        m_hasRttSample = true;
+        m_srttMs = rttMs;
+        m_rttVarMs = rttMs / 2.0;
+    } else {
+        m_rttVarMs = 0.75 * m_rttVarMs + 0.25 * qAbs(m_srttMs - rttMs);
+        m_srttMs = 0.875 * m_srttMs + 0.125 * rttMs;
     }
+    m_rttSamples++;
+
+    // 偏差项至少 1 ms（计时粒度）
+    const double timeout = m_srttMs + qMax(1.0, 4.0 * m_rttVarMs);
+    m_timeoutMs = qBound(MinTimeoutMs, static_cast<int>(std::ceil(timeout)), m_requestTimeout.load());
+}
+
+void ModbusManager::recordTimeout()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_timeoutCount++;
 
-    QModbusDataUnit readUnit(type, address, count);
-    if (auto *reply = m_modbusClient->sendReadRequest(readUnit, m_slaveId)) {
-        while (!reply->isFinished()) {
-            QCoreApplication::processEvents();
+        // 指数退避，收到新的有效样本后重新计算
+        if (m_timeoutMs > 0) {
+            m_timeoutMs = qMin(m_timeoutMs * 2, m_requestTimeout.load());
         }
-        if (reply->error() == QModbusDevice::NoError) {
-            const QModbusDataUnit unit = reply->result();
-            for (quint32 i = 0; i < unit.valueCount(); i++) {
-                result.append(unit.value(i));
-            }
-        } else {
-            m_lastError = reply->errorString();
+    }
+
+    if (++m_consecutiveTimeouts >= LinkDownTimeouts && isConnected()) {
+        declareLinkDown();
+    }
+}
+
+void ModbusManager::markLinkAlive()
+{
+    m_consecutiveTimeouts = 0;
+    m_lastResponse.start();
+}
+
+void ModbusManager::declareLinkDown()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_linkDownCount++;
+        m_lastError = QStringLiteral("链路中断：连续 %1 次请求超时").arg(m_consecutiveTimeouts);
+    }
+    // 立即对其他线程可见，新请求与重发不再进入队列
+    m_connected.store(false);
+    m_consecutiveTimeouts = 0;
+    m_heartbeatTimer->stop();
+
+    // 当前处于回复处理中，断开放到下一轮事件，由状态变化触发排队请求失败与重连
+    QMetaObject::invokeMethod(this, [this]() {
+        failQueuedRequests(QStringLiteral("链路中断"));
+        m_reconnectAttempts = 0;
+        if (transportState() != QModbusDevice::UnconnectedState) {
+            closeTransport();
+        } else if (m_autoReconnect) {
+            scheduleReconnect();
+        }
+    }, Qt::QueuedConnection);
+}
+
+void ModbusManager::failQueuedRequests(const QString &reason)
+{
+    QQueue<PendingRequest> dropped;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (QQueue<PendingRequest> &queue : m_queues) {
+            dropped.append(queue);
+            queue.clear();
+        }
+        if (!dropped.isEmpty()) {
+            m_lastError = reason;
         }
-        reply->deleteLater();
     }
-    return result;
+    for (const PendingRequest &request : dropped) {
+        request.complete(false, nullptr, 0, 0);
+    }
 }
 
-bool ModbusManager::writeRegisters(int address, const QVariantList &values)
+bool ModbusManager::retryAfterTimeout(const PendingRequest &request)
 {
-    if (!isConnected()) {
-        m_lastError = QStringLiteral("未连接到设备");
+    // 写请求超时后无法确定 PLC 是否已执行，重发可能重复写入，直接判定失败
+    if (request.isWrite || request.retried || request.isProbe || !isConnected()) {
         return false;
     }
 
+    int tokens = m_retryTokens.load();
+    do {
+        if (tokens <= 0) {
+            return false;
+        }
+    } while (!m_retryTokens.compare_exchange_weak(tokens, tokens - 1));
+
+    PendingRequest retry = request;
+    retry.retried = true;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_queues[retry.priority].prepend(retry);
+        m_retryCount++;
+    }
+    return true;
+}
+
+void ModbusManager::disconnect()
+{
+    QMetaObject::invokeMethod(this, [this]() {
+        closeTransport();
+    }, Qt::QueuedConnection);
+}
+
+bool ModbusManager::isConnected() const
+{
+    return m_connected.load();
+}
+
+QString ModbusManager::lastError() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lastError;
+}
+
+void ModbusManager::setLastError(const QString &error)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lastError = error;
+}
+
+QFuture<QVector<quint16>> ModbusManager::readHoldingRegistersAsync(int address, int count, int timeoutMs,
+                                                                   RequestPriority priority)
+{
+    return readAsync(QModbusDataUnit::HoldingRegisters, address, count, timeoutMs, priority);
+}
+
+QFuture<QVector<quint16>> ModbusManager::readInputRegistersAsync(int address, int count, int timeoutMs,
+                                                                 RequestPriority priority)
+{
+    return readAsync(QModbusDataUnit::InputRegisters, address, count, timeoutMs, priority);
+}
+
+QFuture<QVector<quint16>> ModbusManager::readCoilsAsync(int address, int count, int timeoutMs,
+                                                        RequestPriority priority)
+{
+    return readAsync(QModbusDataUnit::Coils, address, count, timeoutMs, priority);
+}
+
+QFuture<QVector<quint16>> ModbusManager::readDiscreteInputsAsync(int address, int count, int timeoutMs,
+                                                                 RequestPriority priority)
+{
+    return readAsync(QModbusDataUnit::DiscreteInputs, address, count, timeoutMs, priority);
+}
+
+QFuture<bool> ModbusManager::writeRegistersAsync(int address, const QVector<quint16> &values, int timeoutMs,
+                                                 RequestPriority priority)
+{
+    return writeAsync(QModbusDataUnit::HoldingRegisters, address, values, timeoutMs, priority);
+}
+
+QFuture<bool> ModbusManager::writeCoilAsync(int address, bool value, int timeoutMs, RequestPriority priority)
+{
+    return writeAsync(QModbusDataUnit::Coils, address, QVector<quint16>{quint16(value ? 1 : 0)}, timeoutMs, priority);
+}
+
+QFuture<bool> ModbusManager::writeCoilsAsync(int address, const QVector<quint16> &values, int timeoutMs,
+                                             RequestPriority priority)
+{
     QVector<quint16> data;
-    for (const QVariant &v : values) {
-        data.append(static_cast<quint16>(v.toUInt()));
+    data.reserve(values.size());
+    for (quint16 v : values) {
+        data.append(v ? 1 : 0);
     }
+    return writeAsync(QModbusDataUnit::Coils, address, data, timeoutMs, priority);
+}
 
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, address, data);
-    if (auto *reply = m_modbusClient->sendWriteRequest(writeUnit, m_slaveId)) {
-        while (!reply->isFinished()) {
-            QCoreApplication::processEvents();
-        }
-        bool success = reply->error() == QModbusDevice::NoError;
-        if (!success) {
-            m_lastError = reply->errorString();
+QFuture<QVector<quint16>> ModbusManager::readAsync(QModbusDataUnit::RegisterType type, int address, int count,
+                                                   int timeoutMs, RequestPriority priority)
+{
+    auto *sink = makePromiseSink<QVector<quint16>>([](bool success, const quint16 *values, int valueCount, int) {
+        return success ? QVector<quint16>(values, values + valueCount) : QVector<quint16>();
+    });
+    QFuture<QVector<quint16>> future = sink->future();
+
+    PendingRequest request;
+    request.registerType = type;
+    request.address = address;
+    request.count = count;
+    request.timeoutMs = timeoutMs;
+    request.priority = priority;
+    request.sink = sink;
+    enqueue(std::move(request));
+    return future;
+}
+
+QFuture<ModbusManager::ReadResult> ModbusManager::readDetailedAsync(RegisterType type, int address, int count,
+                                                                    int timeoutMs, RequestPriority priority)
+{
+    auto *sink = makePromiseSink<ReadResult>([](bool success, const quint16 *values, int valueCount,
+                                                int exceptionCode) {
+        ReadResult readResult;
+        if (success) {
+            readResult.values = QVector<quint16>(values, values + valueCount);
         }
-        reply->deleteLater();
+        readResult.exceptionCode = exceptionCode;
+        return readResult;
+    });
+    QFuture<ReadResult> future = sink->future();
+
+    PendingRequest request;
+    request.registerType = unitTypeOf(type);
+    request.address = address;
+    request.count = count;
+    request.timeoutMs = timeoutMs;
+    request.priority = priority;
+    request.sink = sink;
+    enqueue(std::move(request));
+    return future;
+}
+
+void ModbusManager::submitRead(RegisterType type, int address, int count, ResultSink *sink, int tag,
+                               int timeoutMs, RequestPriority priority)
+{
+    PendingRequest request;
+    request.registerType = unitTypeOf(type);
+    request.address = address;
+    request.count = count;
+    request.timeoutMs = timeoutMs;
+    request.priority = priority;
+    request.sink = sink;
+    request.tag = tag;
+    enqueue(std::move(request));
+}
+
+QFuture<bool> ModbusManager::writeAsync(QModbusDataUnit::RegisterType type, int address,
+                                        const QVector<quint16> &values, int timeoutMs, RequestPriority priority)
+{
+    auto *sink = makePromiseSink<bool>([](bool success, const quint16 *, int, int) {
         return success;
-    }
-    return false;
+    });
+    QFuture<bool> future = sink->future();
+
+    PendingRequest request;
+    request.registerType = type;
+    request.address = address;
+    request.count = values.size();
+    request.values = values;
+    request.isWrite = true;
+    request.timeoutMs = timeoutMs;
+    request.priority = priority;
+    request.sink = sink;
+    enqueue(std::move(request));
+    return future;
 }
 
-bool ModbusManager::writeCoil(int address, bool value)
+void ModbusManager::enqueue(PendingRequest request)
 {
+    // 断线期间立即失败，不在队列中堆积
     if (!isConnected()) {
-        m_lastError = QStringLiteral("未连接到设备");
-        return false;
+        setLastError(QStringLiteral("未连接到设备"));
+        request.complete(false, nullptr, 0, 0);
+        return;
     }
 
-    QModbusDataUnit writeUnit(QModbusDataUnit::Coils, address, 1);
-    writeUnit.setValue(0, value ? 1 : 0);
+    bool needDispatch = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        const int priority = request.priority;
+        m_queues[priority].enqueue(std::move(request));
+        if (!m_dispatchPending) {
+            m_dispatchPending = true;
+            needDispatch = true;
+        }
+    }
 
-    if (auto *reply = m_modbusClient->sendWriteRequest(writeUnit, m_slaveId)) {
-        while (!reply->isFinished()) {
-            QCoreApplication::processEvents();
+    // 同一轮事件中入队的请求合并为一次处理
+    if (needDispatch) {
+        QMetaObject::invokeMethod(this, &ModbusManager::processQueue, Qt::QueuedConnection);
+    }
+}
+
+void ModbusManager::processQueue()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_dispatchPending = false;
+    }
+
+    // 在窗口允许范围内连续发送，响应由后端按事务 ID 匹配
+    while (m_inFlight < qMax(1, m_maxInFlight.load())) {
+        PendingRequest request;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!takeNextRequest(request)) {
+                break;
+            }
         }
-        bool success = reply->error() == QModbusDevice::NoError;
-        if (!success) {
-            m_lastError = reply->errorString();
+        dispatch(std::move(request));
+    }
+}
+
+bool ModbusManager::takeNextRequest(PendingRequest &request)
+{
+    for (int priority = OperatorPriority; priority < PriorityCount; ++priority) {
+        QQueue<PendingRequest> &queue = m_queues[priority];
+        if (queue.isEmpty()) {
+            continue;
         }
-        reply->deleteLater();
-        return success;
+
+        // 窗口大于 1 时为操作命令和握手请求保留一个位置，轮询请求不能占满窗口
+        const int window = qMax(1, m_maxInFlight.load());
+        if (priority >= FastPollPriority && window > 1 && m_inFlight >= window - 1) {
+            return false;
+        }
+        request = queue.dequeue();
+        return true;
     }
     return false;
 }
 
-bool ModbusManager::writeCoils(int address, const QVariantList &values)
+void ModbusManager::dispatch(PendingRequest request)
 {
     if (!isConnected()) {
-        m_lastError = QStringLiteral("未连接到设备");
-        return false;
+        setLastError(QStringLiteral("未连接到设备"));
+        request.complete(false, nullptr, 0, 0);
+        return;
     }
 
-    QVector<quint16> data;
-    for (const QVariant &v : values) {
-        data.append(v.toBool() ? 1 : 0);
+    const int timeoutMs = request.timeoutMs > 0 ? request.timeoutMs : adaptiveTimeout();
+    if (m_activeBackend == NativeTcpBackend) {
+        dispatchNative(std::move(request), timeoutMs);
+        return;
     }
 
-    QModbusDataUnit writeUnit(QModbusDataUnit::Coils, address, data);
-    if (auto *reply = m_modbusClient->sendWriteRequest(writeUnit, m_slaveId)) {
-        while (!reply->isFinished()) {
-            QCoreApplication::processEvents();
-        }
+    // 由客户端按本请求的超时结束请求：回复结束前请求在客户端中仍然在途，
+    // 本地提前判定超时会在原请求未结束时释放窗口并重发，超出在途上限甚至重复写入
+    m_modbusClient->setTimeout(qMax(10, timeoutMs));
+
+    const QModbusDataUnit unit = request.isWrite
+        ? QModbusDataUnit(request.registerType, request.address, request.values)
+        : QModbusDataUnit(request.registerType, request.address, static_cast<quint16>(request.count));
+    QModbusReply *reply = request.isWrite
+        ? m_modbusClient->sendWriteRequest(unit, m_slaveId.load())
+        : m_modbusClient->sendReadRequest(unit, m_slaveId.load());
+    if (!reply) {
+        setLastError(m_modbusClient->errorString());
+        request.complete(false, nullptr, 0, 0);
+        return;
+    }
+
+    if (reply->isFinished()) {
         bool success = reply->error() == QModbusDevice::NoError;
         if (!success) {
-            m_lastError = reply->errorString();
+            setLastError(reply->errorString());
         }
+        const QVector<quint16> values = success ? reply->result().values() : QVector<quint16>();
+        request.complete(success, values.constData(), values.size(), exceptionCodeOf(reply));
         reply->deleteLater();
-        return success;
+        return;
     }
-    return false;
+
+    m_inFlight++;
+
+    QElapsedTimer sentAt;
+    sentAt.start();
+
+    connect(reply, &QModbusReply::finished, this, [this, reply, request, sentAt]() {
+        reply->deleteLater();
+
+        const QModbusDevice::Error error = reply->error();
+        if (error == QModbusDevice::NoError) {
+            const QVector<quint16> values = reply->result().values();
+            finishRequest(request, RequestOutcome::Response, values.constData(), values.size(), 0,
+                          sentAt.nsecsElapsed(), QString());
+        } else if (error == QModbusDevice::TimeoutError) {
+            finishRequest(request, RequestOutcome::Timeout, nullptr, 0, 0, 0, reply->errorString());
+        } else if (error == QModbusDevice::ProtocolError) {
+            finishRequest(request, RequestOutcome::Exception, nullptr, 0, exceptionCodeOf(reply),
+                          sentAt.nsecsElapsed(), reply->errorString());
+        } else {
+            finishRequest(request, RequestOutcome::Failed, nullptr, 0, 0, 0, reply->errorString());
+        }
+    });
+}
+
+void ModbusManager::dispatchNative(PendingRequest &&request, int timeoutMs)
+{
+    // 功能码选择与 QModbusTcpClient 一致：单个线圈/寄存器用 05/06，多个用 15/16
+    quint8 function = ModbusTcpCodec::ReadHoldingRegisters;
+    switch (request.registerType) {
+    case QModbusDataUnit::Coils:
+        function = !request.isWrite ? ModbusTcpCodec::ReadCoils
+                 : request.count == 1 ? ModbusTcpCodec::WriteSingleCoil
+                                      : ModbusTcpCodec::WriteMultipleCoils;
+        break;
+    case QModbusDataUnit::DiscreteInputs:
+        function = ModbusTcpCodec::ReadDiscreteInputs;
+        break;
+    case QModbusDataUnit::InputRegisters:
+        function = ModbusTcpCodec::ReadInputRegisters;
+        break;
+    default:
+        function = !request.isWrite ? ModbusTcpCodec::ReadHoldingRegisters
+                 : request.count == 1 ? ModbusTcpCodec::WriteSingleRegister
+                                      : ModbusTcpCodec::WriteMultipleRegisters;
+        break;
+    }
+
+    const int transactionId = m_tcpTransport->send(
+        static_cast<quint8>(m_slaveId.load()), function, static_cast<quint16>(request.address),
+        static_cast<quint16>(request.count), request.isWrite ? request.values.constData() : nullptr, timeoutMs);
+    if (transactionId < 0) {
+        setLastError(m_tcpTransport->errorString());
+        request.complete(false, nullptr, 0, 0);
+        return;
+    }
+
+    NativeTransaction &transaction = m_nativeTransactions[transactionId % ModbusTcpTransport::MaxTransactions];
+    transaction.transactionId = transactionId;
+    transaction.request = std::move(request);
+    transaction.sentAt.start();
+    m_inFlight++;
+}
+
+void ModbusManager::onNativeResponse(int transactionId, ModbusTcpTransport::Status status, int exceptionCode,
+                                     const quint16 *values, int count)
+{
+    NativeTransaction &transaction = m_nativeTransactions[transactionId % ModbusTcpTransport::MaxTransactions];
+    if (transaction.transactionId != transactionId) {
+        return;
+    }
+    transaction.transactionId = -1;
+    const PendingRequest request = std::move(transaction.request);
+    const qint64 elapsedNs = transaction.sentAt.nsecsElapsed();
+
+    switch (status) {
+    case ModbusTcpTransport::Status::Success:
+        finishRequest(request, RequestOutcome::Response, values, count, 0, elapsedNs, QString());
+        break;
+    case ModbusTcpTransport::Status::Exception:
+        finishRequest(request, RequestOutcome::Exception, nullptr, 0, exceptionCode, elapsedNs,
+                      QStringLiteral("PLC 异常响应（异常码 %1）").arg(exceptionCode));
+        break;
+    case ModbusTcpTransport::Status::Timeout:
+        finishRequest(request, RequestOutcome::Timeout, nullptr, 0, 0, 0, QStringLiteral("请求超时"));
+        break;
+    case ModbusTcpTransport::Status::Failed:
+        finishRequest(request, RequestOutcome::Failed, nullptr, 0, 0, 0, m_tcpTransport->errorString());
+        break;
+    }
+}
+
+void ModbusManager::finishRequest(const PendingRequest &request, RequestOutcome outcome, const quint16 *values,
+                                  int count, int exceptionCode, qint64 elapsedNs, const QString &error)
+{
+    switch (outcome) {
+    case RequestOutcome::Timeout:
+        recordTimeout();
+        if (retryAfterTimeout(request)) {
+            onRequestDone();
+            return;
+        }
+        break;
+    case RequestOutcome::Response:
+    case RequestOutcome::Exception:
+        // 正常响应与异常响应都说明链路可达，计入往返时延；重发的请求无法区分响应对应哪一次，不计入
+        markLinkAlive();
+        if (!request.retried) {
+            recordRtt(elapsedNs / 1000000.0);
+        }
+        break;
+    case RequestOutcome::Failed:
+        break;
+    }
+
+    const bool success = outcome == RequestOutcome::Response;
+    if (!success) {
+        setLastError(error);
+    }
+    request.complete(success, success ? values : nullptr, success ? count : 0, exceptionCode);
+    onRequestDone();
+}
+
+void ModbusManager::onRequestDone()
+{
+    m_inFlight--;
+    processQueue();
+}
+
+QVariantList ModbusManager::toVariantList(const QVector<quint16> &values)
+{
+    QVariantList result;
+    result.reserve(values.size());
+    for (quint16 v : values) {
+        result.append(v);
+    }
+    return result;
+}
+
+QVariantList ModbusManager::readHoldingRegisters(int address, int count)
+{
+    return toVariantList(waitForResult(readHoldingRegistersAsync(address, count)));
+}
+
+QVariantList ModbusManager::readInputRegisters(int address, int count)
+{
+    return toVariantList(waitForResult(readInputRegistersAsync(address, count)));
+}
+
+QVariantList ModbusManager::readCoils(int address, int count)
+{
+    return toVariantList(waitForResult(readCoilsAsync(address, count)));
+}
+
+QVariantList ModbusManager::readDiscreteInputs(int address, int count)
+{
+    return toVariantList(waitForResult(readDiscreteInputsAsync(address, count)));
+}
+
+bool ModbusManager::writeRegisters(int address, const QVariantList &values)
+{
+    QVector<quint16> data;
+    data.reserve(values.size());
+    for (const QVariant &v : values) {
+        data.append(static_cast<quint16>(v.toUInt()));
+    }
+    return waitForResult(writeRegistersAsync(address, data));
+}
+
+bool ModbusManager::writeCoil(int address, bool value)
+{
+    return waitForResult(writeCoilAsync(address, value));
+}
+
+bool ModbusManager::writeCoils(int address, const QVariantList &values)
+{
+    QVector<quint16> data;
+    data.reserve(values.size());
+    for (const QVariant &v : values) {
+        data.append(v.toBool() ? 1 : 0);
+    }
+    return waitForResult(writeCoilsAsync(address, data));
 }
 
 void ModbusManager::onStateChanged(QModbusDevice::State state)
 {
     bool connected = (state == QModbusDevice::ConnectedState);
+    m_connected.store(connected);
     emit connectionChanged(connected);
 
     if (connected) {
-        // 连接成功，停止重连定时器
+        // 连接成功，停止重连定时器并开始心跳
         m_reconnectTimer->stop();
         m_reconnectAttempts = 0;
-    } else if (state == QModbusDevice::UnconnectedState && m_autoReconnect) {
+        m_consecutiveTimeouts = 0;
+        m_lastResponse.start();
+        if (m_heartbeatTimer->interval() > 0) {
+            m_heartbeatTimer->start();
+        }
+        return;
+    }
+
+    m_heartbeatTimer->stop();
+    if (state == QModbusDevice::UnconnectedState) {
+        // 断线期间排队的请求立即失败
+        failQueuedRequests(QStringLiteral("未连接到设备"));
+
         // 断开连接且启用自动重连
-        if (!m_reconnectTimer->isActive()) {
-            m_reconnectTimer->start(m_reconnectInterval);
+        if (m_autoReconnect && !m_reconnectTimer->isActive()) {
+            scheduleReconnect();
         }
     }
 }
 
+void ModbusManager::scheduleReconnect()
+{
+    // 首次立即重连（交换机抖动、PLC 重启后通常马上可连），之后指数退避，
+    // 在 [delay/2, delay] 内随机取值，避免多台设备同时重连
+    int delay = 0;
+    if (m_reconnectAttempts > 0) {
+        const int maxDelay = qMax(MinReconnectDelayMs, m_reconnectInterval);
+        const int shift = qMin(m_reconnectAttempts - 1, 16);
+        const int backoff = static_cast<int>(qMin<qint64>(maxDelay, qint64(MinReconnectDelayMs) << shift));
+        delay = backoff / 2 + QRandomGenerator::global()->bounded(backoff / 2 + 1);
+    }
+    m_reconnectTimer->start(delay);
+}
+
+void ModbusManager::onHeartbeat()
+{
+    // 有在途请求时由请求本身的超时检测链路，只在空闲时探测
+    if (!isConnected() || m_inFlight > 0 || m_lastResponse.elapsed() < m_heartbeatTimer->interval()) {
+        return;
+    }
+
+    PendingRequest probe;
+    probe.registerType = QModbusDataUnit::HoldingRegisters;
+    probe.address = m_heartbeatAddress;
+    probe.count = 1;
+    probe.isProbe = true;
+    probe.priority = BackgroundPriority;
+    enqueue(std::move(probe));
+}
+
 void ModbusManager::onErrorOccurred(QModbusDevice::Error error)
 {
     if (error != QModbusDevice::NoError) {
-        m_lastError = m_modbusClient->errorString();
-        emit errorOccurred(m_lastError);
+        const QString errorString = transportErrorString();
+        setLastError(errorString);
+        emit errorOccurred(errorString);
 
         // 连接相关错误时，确保状态正确更新为未连接
         if (error == QModbusDevice::ConnectionError ||
             error == QModbusDevice::TimeoutError ||
             error == QModbusDevice::ProtocolError) {
             // 如果当前不是已连接状态，发射 connectionChanged(false)
-            if (m_modbusClient->state() != QModbusDevice::ConnectedState) {
+            if (transportState() != QModbusDevice::ConnectedState) {
                 emit connectionChanged(false);
             }
         }
@@ -245,6 +941,10 @@ void ModbusManager::tryReconnect()
     m_reconnectAttempts++;
     emit reconnectAttempt(m_reconnectAttempts);
 
-    // 尝试重新连接
-    connectToDevice(m_host, m_port, m_slaveId);
+    // 尝试重新连接；未能发起连接（没有状态变化）时按退避继续安排
+    openConnection();
+    if (m_autoReconnect && transportState() == QModbusDevice::UnconnectedState
+        && !m_reconnectTimer->isActive()) {
+        scheduleReconnect();
+    }
 }
@@ -4,12 +4,26 @@
 #include <QObject>
 #include <QModbusTcpClient>
 #include <QVariantList>
+#include <QVector>
+#include <QFuture>
+#include <QThread>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QQueue>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QVariantMap>
+#include <array>
+#include <atomic>
+#include "ModbusTcpTransport.h"
 
 /**
  * @file ModbusManager.h
  * @brief Modbus TCP 通信管理器
- * @description 负责与 PLC 设备的 Modbus TCP 通信，支持多种寄存器类型的读写操作
+ * @description 负责与 PLC 设备的 Modbus TCP 通信，支持多种寄存器类型的读写操作。
+ *              对象应通过 moveToThread() 运行在独立的 Modbus I/O 线程中：
+ *              其他线程发起的请求进入线程安全的命令队列，由 I/O 线程统一发送，
+ *              结果通过 QFuture 返回，状态变化通过排队信号通知。
  */
 
 class ModbusManager : public QObject
@@ -28,46 +42,264 @@ public:
     };
     Q_ENUM(RegisterType)
 
+    /**
+     * @brief 通信后端
+     */
+    enum Backend {
+        QtModbusBackend = 0,    // QModbusTcpClient
+        NativeTcpBackend        // ModbusTcpTransport：自有 ADU 编解码，请求路径不分配 QModbusReply/QModbusDataUnit
+    };
+    Q_ENUM(Backend)
+
+    /**
+     * @brief 请求优先级，数值越小越优先
+     * @description 每个优先级一个队列，发送时总是先取高优先级队列；轮询请求最多占用在途窗口减一个位置，
+     *              保证操作命令和握手请求到达时不必等待任何轮询请求完成（窗口为 1 时最多等待一个）
+     */
+    enum RequestPriority {
+        OperatorPriority = 0,   // 操作员命令：按钮写入、配方下载
+        HandshakePriority,      // 握手与按需读取：写入前的读-改-写、界面直接读取
+        FastPollPriority,       // 快速轮询
+        BackgroundPriority,     // 常规/慢速轮询、故障定位、心跳探测
+        PriorityCount
+    };
+
+    /**
+     * @brief 带失败原因的读取结果
+     */
+    struct ReadResult {
+        QVector<quint16> values;        // 读取到的值，失败时为空
+        int exceptionCode = 0;          // PLC 返回的 Modbus 异常码（如 0x02 非法数据地址），超时或断线时为 0
+
+        /** @brief 失败是否由 PLC 的异常响应引起（请求本身被拒绝，而非通信故障） */
+        bool isException() const { return exceptionCode != 0; }
+    };
+
+    /**
+     * @brief 请求结果接收方
+     * @description 由调用方预先分配并在请求完成前保持有效，请求完成时在 Modbus I/O 线程中回调。
+     *              请求只记录接收方指针与标签，发送路径不为每个请求分配 QPromise 或回调对象
+     */
+    class ResultSink
+    {
+    public:
+        virtual ~ResultSink() = default;
+
+        /**
+         * @brief 请求完成
+         * @param tag 发起请求时指定的标签
+         * @param values 读取结果，仅在回调期间有效；失败或写请求时为 nullptr
+         * @param exceptionCode PLC 返回的异常码，其他情况为 0
+         */
+        virtual void complete(int tag, bool success, const quint16 *values, int count, int exceptionCode) = 0;
+    };
+
     explicit ModbusManager(QObject *parent = nullptr);
     ~ModbusManager();
 
     /**
-     * @brief 连接到 Modbus 设备
+     * @brief 连接到 Modbus 设备（线程安全，连接在 I/O 线程中异步建立）
      * @param host IP 地址
      * @param port 端口号，默认 502
      * @param slaveId 从站地址，默认 1
-     * @return 是否成功发起连接
+     * @return 是否成功提交连接请求
      */
     bool connectToDevice(const QString &host, int port = 502, int slaveId = 1);
 
     /**
-     * @brief 断开连接
+     * @brief 断开连接（线程安全）
      */
     void disconnect();
 
     /**
-     * @brief 检查是否已连接
+     * @brief 检查是否已连接（线程安全）
      */
     bool isConnected() const;
 
     /**
      * @brief 获取从站地址
      */
-    int slaveId() const { return m_slaveId; }
+    int slaveId() const { return m_slaveId.load(); }
 
     /**
      * @brief 设置从站地址
      */
-    void setSlaveId(int slaveId) { m_slaveId = slaveId; }
+    void setSlaveId(int slaveId) { m_slaveId.store(slaveId); }
 
     /**
-     * @brief 设置自动重连
+     * @brief 设置通信后端（线程安全）
+     * @description 在下次建立连接时生效，连接中切换会先断开原后端
+     */
+    void setBackend(Backend backend);
+
+    /**
+     * @brief 获取通信后端
+     */
+    Backend backend() const { return static_cast<Backend>(m_backend.load()); }
+
+    /**
+     * @brief 设置自动重连（线程安全）
+     * @description 断线后立即重连一次，之后按指数退避加随机抖动重试，
+     *              避免多台设备在交换机恢复后同时重连
      * @param enabled 是否启用
-     * @param intervalMs 重连间隔（毫秒）
+     * @param intervalMs 最大重连间隔（毫秒）
      */
     void setAutoReconnect(bool enabled, int intervalMs = 5000);
 
-    // ========== 读取操作 ==========
+    /**
+     * @brief 设置心跳探测（线程安全）
+     * @description 链路空闲超过 intervalMs 时读取一个保持寄存器作为探测，
+     *              连续 LinkDownTimeouts 次请求超时（含探测）即判定链路中断，主动断开并重连。
+     *              PLC 以异常响应拒绝探测地址同样说明链路可达
+     * @param intervalMs 空闲探测间隔（毫秒），0 表示关闭心跳
+     * @param address 探测读取的保持寄存器地址
+     */
+    void setHeartbeat(int intervalMs, int address = 0);
+
+    /**
+     * @brief 设置同时在途的最大请求数（线程安全）
+     * @description Modbus TCP 通过事务 ID 匹配响应，允许多个请求流水线发送；
+     *              超出窗口的请求在命令队列中等待
+     * @param count 窗口大小，取值范围 1 ~ ModbusTcpTransport::MaxTransactions
+     */
+    void setMaxInFlight(int count);
+
+    /**
+     * @brief 获取同时在途的最大请求数
+     */
+    int maxInFlight() const { return m_maxInFlight.load(); }
+
+    /**
+     * @brief 设置请求超时上限（线程安全）
+     * @description 实际超时按实测往返时延自适应计算（与 TCP RTO 相同：平滑 RTT + 4 倍偏差），
+     *              取值范围为 MinTimeoutMs 到该上限；尚无测量值时使用该上限
+     * @param timeoutMs 超时时间（毫秒）
+     */
+    void setRequestTimeout(int timeoutMs);
+
+    /**
+     * @brief 获取请求超时上限（毫秒）
+     */
+    int requestTimeout() const { return m_requestTimeout.load(); }
+
+    /**
+     * @brief 设置每个轮询周期的重试预算（线程安全）
+     * @description 超时的读请求在预算内重发一次，预算由 beginCycle() 补满；预算耗尽后超时直接判定失败，
+     *              避免链路中断时每个请求都重试而拖慢整个周期。写请求超时后从不重发。
+     *              预算由所有轮询等级与按需请求共用，PlcBridge 只在常规等级（NormalPoll）的周期开始时补满，
+     *              即每个常规轮询周期内全部请求合计最多重试 retries 次
+     * @param retries 每周期最多重试次数，0 表示不重试
+     */
+    void setRetryBudget(int retries);
+
+    /**
+     * @brief 获取每个轮询周期的重试预算
+     */
+    int retryBudget() const { return m_retryBudget.load(); }
+
+    /**
+     * @brief 开始新的轮询周期，补满重试预算（线程安全）
+     * @description 只应由一个参考轮询等级调用，见 setRetryBudget
+     */
+    void beginCycle() { m_retryTokens.store(m_retryBudget.load()); }
+
+    /**
+     * @brief 获取链路时延统计（线程安全）
+     * @return {srttMs, rttVarMs, timeoutMs, samples, timeouts, retries, linkDowns}
+     */
+    QVariantMap linkStats() const;
+
+    /** 自适应超时下限（毫秒），避免定时器精度与偶发抖动造成误判 */
+    static constexpr int MinTimeoutMs = 50;
+
+    /** 判定链路中断的连续超时次数 */
+    static constexpr int LinkDownTimeouts = 3;
+
+    /** 首次退避的重连间隔（毫秒） */
+    static constexpr int MinReconnectDelayMs = 200;
+
+    // ========== 异步读取操作 ==========
+    // 异步接口可在任意线程调用，立即返回 QFuture，不阻塞调用方也不重入事件循环
+    // 失败时结果为空列表，错误信息通过 lastError() 获取
+    // timeoutMs 为该请求的超时时间，0 表示自适应超时
+    // priority 为请求优先级，读取默认按需读取（握手），写入默认操作员命令
+
+    /**
+     * @brief 异步读取保持寄存器（功能码 03）
+     * @param address 起始地址
+     * @param count 寄存器数量
+     * @param timeoutMs 请求超时（毫秒），0 表示默认值
+     * @return 寄存器值列表的 Future
+     */
+    QFuture<QVector<quint16>> readHoldingRegistersAsync(int address, int count, int timeoutMs = 0,
+                                                        RequestPriority priority = HandshakePriority);
+
+    /**
+     * @brief 异步读取输入寄存器（功能码 04）
+     */
+    QFuture<QVector<quint16>> readInputRegistersAsync(int address, int count, int timeoutMs = 0,
+                                                      RequestPriority priority = HandshakePriority);
+
+    /**
+     * @brief 异步读取线圈状态（功能码 01），每个线圈对应一个 0/1 值
+     */
+    QFuture<QVector<quint16>> readCoilsAsync(int address, int count, int timeoutMs = 0,
+                                             RequestPriority priority = HandshakePriority);
+
+    /**
+     * @brief 异步读取离散输入（功能码 02），每个输入对应一个 0/1 值
+     */
+    QFuture<QVector<quint16>> readDiscreteInputsAsync(int address, int count, int timeoutMs = 0,
+                                                      RequestPriority priority = HandshakePriority);
+
+    /**
+     * @brief 异步读取，失败时携带 PLC 返回的异常码
+     * @description 用于区分地址配置错误（异常响应）与超时、断线等通信故障
+     * @param type 寄存器类型
+     */
+    QFuture<ReadResult> readDetailedAsync(RegisterType type, int address, int count, int timeoutMs = 0,
+                                          RequestPriority priority = HandshakePriority);
+
+    /**
+     * @brief 异步读取，结果交给预先分配的接收方
+     * @description 用于周期性轮询：不创建 Future，稳定运行时请求路径不分配内存；
+     *              接收方在 I/O 线程中被回调，需自行保证跨线程访问结果的同步
+     * @param sink 结果接收方，请求完成前必须保持有效
+     * @param tag 回调时原样传回的标签
+     */
+    void submitRead(RegisterType type, int address, int count, ResultSink *sink, int tag, int timeoutMs = 0,
+                    RequestPriority priority = HandshakePriority);
+
+    // ========== 异步写入操作 ==========
+
+    /**
+     * @brief 异步写入保持寄存器（功能码 06/16）
+     * @param address 起始地址
+     * @param values 要写入的寄存器值
+     * @param timeoutMs 请求超时（毫秒），0 表示默认值
+     * @return 是否写入成功的 Future
+     */
+    QFuture<bool> writeRegistersAsync(int address, const QVector<quint16> &values, int timeoutMs = 0,
+                                      RequestPriority priority = OperatorPriority);
+
+    /**
+     * @brief 异步写入单个线圈（功能码 05）
+     */
+    QFuture<bool> writeCoilAsync(int address, bool value, int timeoutMs = 0,
+                                 RequestPriority priority = OperatorPriority);
+
+    /**
+     * @brief 异步写入多个线圈（功能码 15），非零值表示 ON
+     */
+    QFuture<bool> writeCoilsAsync(int address, const QVector<quint16> &values, int timeoutMs = 0,
+                                  RequestPriority priority = OperatorPriority);
+
+    /** @brief 将寄存器值转换为 QVariantList（兼容旧接口） */
+    static QVariantList toVariantList(const QVector<quint16> &values);
+
+    // ========== 读取操作（同步，基于异步接口的封装） ==========
+    // 同步接口只供工作线程中的调用方使用；GUI 线程与 I/O 线程调用时不等待，直接返回空结果，
+    // GUI 线程应使用 *Async 接口并以 .then(context, ...) 处理结果
 
     /**
      * @brief 读取保持寄存器（功能码 03）
@@ -101,7 +333,7 @@ public:
      */
     QVariantList readDiscreteInputs(int address, int count);
 
-    // ========== 写入操作 ==========
+    // ========== 写入操作（同步，基于异步接口的封装，同样只供工作线程使用） ==========
 
     /**
      * @brief 写入保持寄存器（功能码 06/16）
@@ -128,9 +360,35 @@ public:
     bool writeCoils(int address, const QVariantList &values);
 
     /**
-     * @brief 获取最后一次错误信息
+     * @brief 等待异步结果（同步封装使用）
+     * @description 在调用线程中阻塞等待 I/O 线程完成请求，不运行事件循环。
+     *              不能在 Modbus I/O 线程内调用，否则返回空结果以避免死锁；
+     *              也不能在 GUI 线程内调用，否则返回空结果以避免界面与 WebChannel 卡顿。
+     * @param future 异步操作返回的 Future
+     * @return 异步操作结果
      */
-    QString lastError() const { return m_lastError; }
+    template <typename T>
+    T waitForResult(QFuture<T> future) const
+    {
+        if (future.isFinished()) {
+            return future.result();
+        }
+        if (QThread::currentThread() == thread()) {
+            qWarning("ModbusManager: 不能在 Modbus I/O 线程内同步等待请求结果");
+            return T();
+        }
+        if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread()) {
+            qWarning("ModbusManager: 不能在 GUI 线程内同步等待请求结果，请使用异步接口");
+            return T();
+        }
+        future.waitForFinished();
+        return future.result();
+    }
+
+    /**
+     * @brief 获取最后一次错误信息（线程安全）
+     */
+    QString lastError() const;
 
 signals:
     /** @brief 连接状态变化信号 */
@@ -147,27 +405,190 @@ private slots:
     void onErrorOccurred(QModbusDevice::Error error);
     void tryReconnect();
 
+    /** @brief 链路空闲时发送心跳探测 */
+    void onHeartbeat();
+
+    /** @brief 在 I/O 线程中按在途窗口发送命令队列中的请求 */
+    void processQueue();
+
 private:
     /**
-     * @brief 通用读取方法
+     * @brief 命令队列中的待发送请求
+     */
+    struct PendingRequest {
+        QModbusDataUnit::RegisterType registerType = QModbusDataUnit::HoldingRegisters;  // 寄存器类型
+        int address = 0;                // 起始地址
+        int count = 0;                  // 读写数量
+        QVector<quint16> values;        // 写入数据，读请求为空
+        bool isWrite = false;           // 是否为写请求
+        int timeoutMs = 0;              // 请求超时，0 表示自适应超时
+        bool retried = false;           // 是否为超时后的重发（不参与往返时延测量）
+        bool isProbe = false;           // 是否为心跳探测（超时不重发）
+        RequestPriority priority = BackgroundPriority;  // 请求优先级
+        ResultSink *sink = nullptr;     // 结果接收方，nullptr 表示不关心结果（心跳探测）
+        int tag = 0;                    // 接收方的标签
+
+        /** @brief 通知接收方请求完成，values 仅在调用期间有效 */
+        void complete(bool success, const quint16 *values, int count, int exceptionCode) const
+        {
+            if (sink) {
+                sink->complete(tag, success, values, count, exceptionCode);
+            }
+        }
+    };
+
+    /**
+     * @brief 自有传输层的在途请求，按事务 ID 对 MaxTransactions 取模存放
+     */
+    struct NativeTransaction {
+        int transactionId = -1;         // 事务 ID，-1 表示空闲
+        PendingRequest request;
+        QElapsedTimer sentAt;           // 发送时刻，用于往返时延测量
+    };
+
+    /**
+     * @brief 请求结束方式
+     */
+    enum class RequestOutcome {
+        Response,       // 正常响应
+        Exception,      // 异常响应或无法解析的响应（链路可达）
+        Timeout,        // 超时
+        Failed          // 断线等其他失败
+    };
+
+    /** @brief 请求入队并唤醒 I/O 线程（线程安全） */
+    void enqueue(PendingRequest request);
+
+    /** @brief 在 I/O 线程中发送单个请求，完成或超时后释放窗口 */
+    void dispatch(PendingRequest request);
+
+    /** @brief 通过自有传输层发送请求 */
+    void dispatchNative(PendingRequest &&request, int timeoutMs);
+
+    /** @brief 自有传输层的响应回调 */
+    void onNativeResponse(int transactionId, ModbusTcpTransport::Status status, int exceptionCode,
+                          const quint16 *values, int count);
+
+    /** @brief 请求结束的统一处理：时延统计、超时重发、错误记录与完成回调，并释放窗口 */
+    void finishRequest(const PendingRequest &request, RequestOutcome outcome, const quint16 *values, int count,
+                       int exceptionCode, qint64 elapsedNs, const QString &error);
+
+    /** @brief 在途请求完成（含超时），释放窗口并继续发送 */
+    void onRequestDone();
+
+    /** @brief 当前自适应超时（毫秒） */
+    int adaptiveTimeout() const;
+
+    /** @brief 记录一次往返时延样本并更新超时 */
+    void recordRtt(double rttMs);
+
+    /** @brief 记录一次超时，超时时间加倍（不超过上限），连续超时达到阈值时判定链路中断 */
+    void recordTimeout();
+
+    /** @brief 收到响应（含异常响应），链路可达 */
+    void markLinkAlive();
+
+    /** @brief 判定链路中断：后续请求立即失败，并主动断开以触发重连 */
+    void declareLinkDown();
+
+    /** @brief 取出下一个可发送的请求：高优先级优先，轮询请求不占用保留的窗口位置（调用方持有 m_mutex） */
+    bool takeNextRequest(PendingRequest &request);
+
+    /** @brief 使命令队列中尚未发送的请求全部失败 */
+    void failQueuedRequests(const QString &reason);
+
+    /** @brief 按重连次数安排下一次重连：首次立即重连，之后指数退避加抖动 */
+    void scheduleReconnect();
+
+    /** @brief 超时的请求在重试预算内插回队首重发，已重发过或预算耗尽时返回 false */
+    bool retryAfterTimeout(const PendingRequest &request);
+
+    /** @brief 在 I/O 线程中按已保存的参数建立连接 */
+    void openConnection();
+
+    /** @brief 当前后端的连接状态 */
+    QModbusDevice::State transportState() const;
+
+    /** @brief 当前后端的错误信息 */
+    QString transportErrorString() const;
+
+    /** @brief 断开当前后端 */
+    void closeTransport();
+
+    /** @brief 记录错误信息（线程安全） */
+    void setLastError(const QString &error);
+
+    /**
+     * @brief 通用异步读取方法
      * @param type 寄存器类型
      * @param address 起始地址
      * @param count 数量
-     * @return 读取结果
+     * @param timeoutMs 请求超时
+     * @param priority 请求优先级
+     * @return 读取结果的 Future
      */
-    QVariantList readRegisters(QModbusDataUnit::RegisterType type, int address, int count);
+    QFuture<QVector<quint16>> readAsync(QModbusDataUnit::RegisterType type, int address, int count,
+                                        int timeoutMs, RequestPriority priority);
 
-    QModbusTcpClient *m_modbusClient;   // Modbus 客户端
-    int m_slaveId;                       // 从站地址
+    /**
+     * @brief 通用异步写入方法
+     * @param type 寄存器类型
+     * @param address 起始地址
+     * @param values 待写入的值，线圈为 0/1
+     * @param timeoutMs 请求超时
+     * @param priority 请求优先级
+     * @return 是否写入成功的 Future
+     */
+    QFuture<bool> writeAsync(QModbusDataUnit::RegisterType type, int address, const QVector<quint16> &values,
+                             int timeoutMs, RequestPriority priority);
+
+    QModbusTcpClient *m_modbusClient;   // Modbus 客户端（仅在 I/O 线程中访问）
+    ModbusTcpTransport *m_tcpTransport;  // 自有传输层（仅在 I/O 线程中访问）
+    std::atomic<int> m_backend;          // 下次连接使用的后端
+    Backend m_activeBackend;             // 当前连接使用的后端（仅 I/O 线程访问）
+    std::array<NativeTransaction, ModbusTcpTransport::MaxTransactions> m_nativeTransactions;  // 自有传输层的在途请求
+    std::atomic<int> m_slaveId;          // 从站地址
+    std::atomic<bool> m_connected;       // 连接状态（供其他线程查询）
     QString m_host;                      // 主机地址
     int m_port;                          // 端口号
     QString m_lastError;                 // 最后错误信息
 
+    // 命令队列相关（由 m_mutex 保护）
+    mutable QMutex m_mutex;              // 保护队列、连接参数和错误信息
+    QQueue<PendingRequest> m_queues[PriorityCount];  // 按优先级划分的待发送请求队列
+    bool m_dispatchPending;              // 是否已投递队列处理事件
+
+    // 流水线相关
+    std::atomic<int> m_maxInFlight;      // 在途窗口大小
+    std::atomic<int> m_requestTimeout;   // 请求超时上限
+    int m_inFlight;                      // 当前在途请求数（仅 I/O 线程访问）
+
+    // 自适应超时（I/O 线程写入，由 m_mutex 保护）
+    bool m_hasRttSample;                 // 是否已有往返时延样本
+    double m_srttMs;                     // 平滑往返时延
+    double m_rttVarMs;                   // 往返时延平均偏差
+    int m_timeoutMs;                     // 当前超时，0 表示尚未计算（使用上限）
+    qint64 m_rttSamples;                 // 样本数
+    qint64 m_timeoutCount;               // 超时次数
+    qint64 m_retryCount;                 // 重发次数
+    qint64 m_linkDownCount;              // 判定链路中断的次数
+
+    // 重试预算
+    std::atomic<int> m_retryBudget;      // 每周期重试次数
+    std::atomic<int> m_retryTokens;      // 本周期剩余重试次数
+
+    // 链路检测（仅 I/O 线程访问）
+    QTimer *m_heartbeatTimer;            // 心跳定时器
+    QElapsedTimer m_lastResponse;        // 上次收到响应的时刻
+    int m_heartbeatAddress;              // 心跳探测地址
+    int m_consecutiveTimeouts;           // 连续超时次数，收到任意响应时清零
+
     // 自动重连相关
-    QTimer *m_reconnectTimer;            // 重连定时器
+    QTimer *m_reconnectTimer;            // 重连定时器（单次触发）
     bool m_autoReconnect;                // 是否自动重连
-    int m_reconnectInterval;             // 重连间隔
+    int m_reconnectInterval;             // 最大重连间隔
     int m_reconnectAttempts;             // 重连尝试次数
+    int m_connectSerial;                 // 连接尝试序号，用于识别过期的连接超时
 };
 
 #endif // MODBUSMANAGER_H
@@ -0,0 +1,43 @@
+#ifndef MODBUSSIGNAL_H
+#define MODBUSSIGNAL_H
+
+#include <QString>
+
+/**
+ * @file ModbusSignal.h
+ * @brief 信号配置数据结构
+ * @description 存储从 ERP 同步的单个 PLC 信号配置
+ */
+
+/**
+ * @brief 信号配置结构体
+ */
+struct ModbusSignal {
+    qint64 id;                  // 信号 ID
+    qint64 deviceId;            // 设备 ID
+    QString signalCode;         // 信号编码
+    QString signalName;         // 信号名称
+    QString signalType;         // 信号类型：read/write
+    QString registerType;       // 寄存器类型：1=线圈, 3=保持寄存器
+    int registerAddress;        // 寄存器地址
+    QString dataType;           // 数据类型：bit/word/float/double
+    int registerCount;          // 寄存器数量
+    int scaleFactor;            // 比例因子
+    int offsetValue;            // 偏移量
+    int bitIndex;               // 保持寄存器内的位序号（0-15），-1 表示使用整个寄存器
+    QString unit;               // 单位
+    QString plcAreaType;        // PLC 软元件区域类型
+    QString paramGroup;         // 参数组别
+    bool isActive;              // 是否启用
+    double deadband;            // 死区：变化量不超过死区时不上报，0 表示不启用
+    bool deadbandPercent;       // 死区是否为百分比（相对上次上报值）
+    int minReportInterval;      // 最小上报间隔（毫秒），0 表示不限制
+
+    ModbusSignal()
+        : id(0), deviceId(0), registerAddress(0)
+        , registerCount(1), scaleFactor(1), offsetValue(0), bitIndex(-1)
+        , isActive(true), deadband(0.0), deadbandPercent(false)
+        , minReportInterval(0) {}
+};
+
+#endif // MODBUSSIGNAL_H
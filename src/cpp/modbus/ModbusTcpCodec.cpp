@@ -0,0 +1,163 @@
+#include "ModbusTcpCodec.h"
+#include <QtEndian>
+#include <cstring>
+
+/**
+ * @file ModbusTcpCodec.cpp
+ * @brief Modbus TCP ADU 编解码实现
+ */
+
+namespace {
+/** MBAP 长度字段的上限：单元 ID + 253 字节 PDU */
+constexpr int MaxMbapLength = 254;
+
+void putWord(quint8 *out, quint16 value)
+{
+    qToBigEndian(value, out);
+}
+
+quint16 getWord(const quint8 *data)
+{
+    return qFromBigEndian<quint16>(data);
+}
+}
+
+int ModbusTcpCodec::encodeRequest(quint8 *out, quint16 transactionId, quint8 unitId, quint8 function,
+                                  quint16 address, quint16 count, const quint16 *values)
+{
+    quint8 *pdu = out + HeaderSize;
+    pdu[0] = function;
+    putWord(pdu + 1, address);
+
+    int pduLength = 5;
+    switch (function) {
+    case ReadCoils:
+    case ReadDiscreteInputs:
+        if (count < 1 || count > MaxReadBits) {
+            return 0;
+        }
+        putWord(pdu + 3, count);
+        break;
+    case ReadHoldingRegisters:
+    case ReadInputRegisters:
+        if (count < 1 || count > MaxReadRegisters) {
+            return 0;
+        }
+        putWord(pdu + 3, count);
+        break;
+    case WriteSingleCoil:
+        putWord(pdu + 3, values[0] ? 0xFF00 : 0x0000);
+        break;
+    case WriteSingleRegister:
+        putWord(pdu + 3, values[0]);
+        break;
+    case WriteMultipleCoils: {
+        if (count < 1 || count > MaxWriteBits) {
+            return 0;
+        }
+        const int byteCount = (count + 7) / 8;
+        putWord(pdu + 3, count);
+        pdu[5] = static_cast<quint8>(byteCount);
+        quint8 *bits = pdu + 6;
+        std::memset(bits, 0, byteCount);
+        for (int i = 0; i < count; ++i) {
+            if (values[i]) {
+                bits[i >> 3] |= static_cast<quint8>(1u << (i & 7));
+            }
+        }
+        pduLength = 6 + byteCount;
+        break;
+    }
+    case WriteMultipleRegisters: {
+        if (count < 1 || count > MaxWriteRegisters) {
+            return 0;
+        }
+        putWord(pdu + 3, count);
+        pdu[5] = static_cast<quint8>(count * 2);
+        for (int i = 0; i < count; ++i) {
+            putWord(pdu + 6 + 2 * i, values[i]);
+        }
+        pduLength = 6 + count * 2;
+        break;
+    }
+    default:
+        return 0;
+    }
+
+    // MBAP：事务 ID、协议 ID（固定 0）、后续字节数、单元 ID
+    putWord(out, transactionId);
+    putWord(out + 2, 0);
+    putWord(out + 4, static_cast<quint16>(pduLength + 1));
+    out[6] = unitId;
+    return HeaderSize + pduLength;
+}
+
+int ModbusTcpCodec::frameLength(const quint8 *data, int size)
+{
+    if (size < HeaderSize) {
+        return 0;
+    }
+    const int length = getWord(data + 4);
+    if (getWord(data + 2) != 0 || length < 2 || length > MaxMbapLength) {
+        return -1;
+    }
+    const int total = 6 + length;
+    return size >= total ? total : 0;
+}
+
+quint16 ModbusTcpCodec::transactionId(const quint8 *frame)
+{
+    return getWord(frame);
+}
+
+ModbusTcpCodec::Result ModbusTcpCodec::decodeResponse(const quint8 *frame, int length, quint8 function, int count,
+                                                      quint16 *out, int *exceptionCode)
+{
+    const quint8 *pdu = frame + HeaderSize;
+    const int pduLength = length - HeaderSize;
+
+    if ((pdu[0] & 0x7F) != function) {
+        return Result::Malformed;
+    }
+    if (pdu[0] & 0x80) {
+        if (pduLength < 2) {
+            return Result::Malformed;
+        }
+        *exceptionCode = pdu[1];
+        return Result::Exception;
+    }
+
+    switch (function) {
+    case ReadCoils:
+    case ReadDiscreteInputs: {
+        const int byteCount = (count + 7) / 8;
+        if (pduLength < 2 + byteCount || pdu[1] != byteCount) {
+            return Result::Malformed;
+        }
+        const quint8 *bits = pdu + 2;
+        for (int i = 0; i < count; ++i) {
+            out[i] = (bits[i >> 3] >> (i & 7)) & 1u;
+        }
+        return Result::Ok;
+    }
+    case ReadHoldingRegisters:
+    case ReadInputRegisters: {
+        if (pduLength < 2 + count * 2 || pdu[1] != count * 2) {
+            return Result::Malformed;
+        }
+        const quint8 *words = pdu + 2;
+        for (int i = 0; i < count; ++i) {
+            out[i] = getWord(words + 2 * i);
+        }
+        return Result::Ok;
+    }
+    case WriteSingleCoil:
+    case WriteSingleRegister:
+    case WriteMultipleCoils:
+    case WriteMultipleRegisters:
+        // 写响应回显地址与值/数量
+        return pduLength >= 5 ? Result::Ok : Result::Malformed;
+    default:
+        return Result::Malformed;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef MODBUSTCPCODEC_H
+#define MODBUSTCPCODEC_H
+
+#include <QtGlobal>
+
+/**
+ * @file ModbusTcpCodec.h
+ * @brief Modbus TCP 应用数据单元（ADU）编解码
+ * @description MBAP 报文头（事务 ID、协议 ID、长度、单元 ID）加 PDU 的编码与解析。
+ *              只操作调用方提供的缓冲区，不分配内存；支持功能码 01~06、15、16
+ */
+
+class ModbusTcpCodec
+{
+public:
+    /**
+     * @brief 支持的功能码
+     */
+    enum FunctionCode : quint8 {
+        ReadCoils = 0x01,
+        ReadDiscreteInputs = 0x02,
+        ReadHoldingRegisters = 0x03,
+        ReadInputRegisters = 0x04,
+        WriteSingleCoil = 0x05,
+        WriteSingleRegister = 0x06,
+        WriteMultipleCoils = 0x0F,
+        WriteMultipleRegisters = 0x10
+    };
+
+    /**
+     * @brief 响应解析结果
+     */
+    enum class Result {
+        Ok,             // 正常响应，数据已写入输出缓冲区
+        Exception,      // PLC 返回异常响应
+        Malformed       // 功能码、长度或字节数与请求不符
+    };
+
+    /** MBAP 报文头长度（含单元 ID） */
+    static constexpr int HeaderSize = 7;
+
+    /** ADU 最大长度：报文头 + 253 字节 PDU */
+    static constexpr int MaxAduSize = 260;
+
+    /** 单次读取的最大寄存器数 / 位数 */
+    static constexpr int MaxReadRegisters = 125;
+    static constexpr int MaxReadBits = 2000;
+
+    /** 单次写入的最大寄存器数 / 位数 */
+    static constexpr int MaxWriteRegisters = 123;
+    static constexpr int MaxWriteBits = 1968;
+
+    /**
+     * @brief 编码请求 ADU
+     * @param out 输出缓冲区，至少 MaxAduSize 字节
+     * @param values 写请求的寄存器值（线圈为 0/非 0），读请求为 nullptr
+     * @param count 读写数量；写单个线圈/寄存器时为 1
+     * @return ADU 长度，参数超出协议限制时返回 0
+     */
+    static int encodeRequest(quint8 *out, quint16 transactionId, quint8 unitId, quint8 function,
+                             quint16 address, quint16 count, const quint16 *values);
+
+    /**
+     * @brief 根据报文头计算完整 ADU 长度
+     * @param size data 中已接收的字节数
+     * @return 完整 ADU 长度；报文头未收齐时返回 0；协议 ID 或长度非法时返回 -1（需要断开重新同步）
+     */
+    static int frameLength(const quint8 *data, int size);
+
+    /** @brief ADU 的事务 ID */
+    static quint16 transactionId(const quint8 *frame);
+
+    /**
+     * @brief 解析响应 ADU
+     * @param frame 完整 ADU（长度由 frameLength 给出）
+     * @param function 请求的功能码
+     * @param count 请求的数量，读响应据此校验字节数
+     * @param out 读响应的输出缓冲区，至少 count 个元素；线圈/离散输入每个元素为 0/1
+     * @param exceptionCode 异常响应时输出异常码
+     */
+    static Result decodeResponse(const quint8 *frame, int length, quint8 function, int count,
+                                 quint16 *out, int *exceptionCode);
+};
+
+#endif // MODBUSTCPCODEC_H
@@ -0,0 +1,252 @@
+#include "ModbusTcpTransport.h"
+#include <cstring>
+
+/**
+ * @file ModbusTcpTransport.cpp
+ * @brief 轻量 Modbus TCP 传输层实现
+ */
+
+ModbusTcpTransport::ModbusTcpTransport(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QTcpSocket(this))
+    , m_deadlineTimer(new QTimer(this))
+    , m_state(QModbusDevice::UnconnectedState)
+    , m_activeCount(0)
+    , m_nextTransactionId(1)
+    , m_rxSize(0)
+{
+    m_clock.start();
+
+    m_deadlineTimer->setSingleShot(true);
+    m_deadlineTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_deadlineTimer, &QTimer::timeout, this, &ModbusTcpTransport::onDeadline);
+
+    connect(m_socket, &QAbstractSocket::stateChanged, this, &ModbusTcpTransport::onSocketStateChanged);
+    connect(m_socket, &QAbstractSocket::errorOccurred, this, &ModbusTcpTransport::onSocketError);
+    connect(m_socket, &QIODevice::readyRead, this, &ModbusTcpTransport::onReadyRead);
+}
+
+void ModbusTcpTransport::connectDevice(const QString &host, int port)
+{
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+    m_socket->connectToHost(host, static_cast<quint16>(port));
+}
+
+void ModbusTcpTransport::disconnectDevice()
+{
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+}
+
+int ModbusTcpTransport::send(quint8 unitId, quint8 function, quint16 address, quint16 count,
+                             const quint16 *values, int timeoutMs)
+{
+    if (m_state != QModbusDevice::ConnectedState) {
+        m_errorString = QStringLiteral("未连接到设备");
+        return -1;
+    }
+
+    if (m_activeCount >= MaxTransactions) {
+        m_errorString = QStringLiteral("在途请求过多");
+        return -1;
+    }
+
+    // 从下一个事务 ID 起向后找空闲槽位，长时间未响应的事务不会挡住后续请求；
+    // 65536 是 MaxTransactions 的整数倍，ID 回绕后与槽位的对应关系不变
+    quint16 id = m_nextTransactionId;
+    while (m_transactions[id % MaxTransactions].active) {
+        ++id;
+    }
+    Transaction &transaction = m_transactions[id % MaxTransactions];
+
+    const int length = ModbusTcpCodec::encodeRequest(m_txBuffer.data(), id, unitId, function, address, count, values);
+    if (length == 0) {
+        m_errorString = QStringLiteral("请求参数超出协议限制");
+        return -1;
+    }
+    if (m_socket->write(reinterpret_cast<const char *>(m_txBuffer.data()), length) != length) {
+        m_errorString = m_socket->errorString();
+        return -1;
+    }
+
+    m_nextTransactionId = static_cast<quint16>(id + 1);
+    transaction.active = true;
+    transaction.id = id;
+    transaction.function = function;
+    transaction.count = count;
+    transaction.deadlineMs = m_clock.elapsed() + qMax(1, timeoutMs);
+    m_activeCount++;
+
+    // 新请求比当前定时器更早到期时提前定时器
+    if (!m_deadlineTimer->isActive() || m_deadlineTimer->remainingTime() > timeoutMs) {
+        m_deadlineTimer->start(qMax(1, timeoutMs));
+    }
+    return id;
+}
+
+void ModbusTcpTransport::onReadyRead()
+{
+    for (;;) {
+        const qint64 received = m_socket->read(reinterpret_cast<char *>(m_rxBuffer.data()) + m_rxSize,
+                                               static_cast<qint64>(m_rxBuffer.size()) - m_rxSize);
+        if (received <= 0) {
+            return;
+        }
+        m_rxSize += static_cast<int>(received);
+
+        // 逐个处理完整的 ADU，不完整的尾部留待下次
+        int offset = 0;
+        for (;;) {
+            const quint8 *frame = m_rxBuffer.data() + offset;
+            const int length = ModbusTcpCodec::frameLength(frame, m_rxSize - offset);
+            if (length < 0) {
+                // 报文头非法，字节流已失步，只能断开重连
+                m_errorString = QStringLiteral("响应报文格式错误");
+                emit errorOccurred(QModbusDevice::ProtocolError);
+                m_socket->abort();
+                return;
+            }
+            if (length == 0) {
+                break;
+            }
+            offset += length;
+
+            // 超时后才到达的响应对应的事务已结束，直接丢弃
+            const quint16 id = ModbusTcpCodec::transactionId(frame);
+            Transaction &transaction = m_transactions[id % MaxTransactions];
+            if (!transaction.active || transaction.id != id) {
+                continue;
+            }
+
+            int exceptionCode = 0;
+            switch (ModbusTcpCodec::decodeResponse(frame, length, transaction.function, transaction.count,
+                                                   m_values.data(), &exceptionCode)) {
+            case ModbusTcpCodec::Result::Ok:
+                if (transaction.function <= ModbusTcpCodec::ReadInputRegisters) {
+                    finish(transaction, Status::Success, 0, m_values.data(), transaction.count);
+                } else {
+                    finish(transaction, Status::Success, 0, nullptr, 0);
+                }
+                break;
+            case ModbusTcpCodec::Result::Exception:
+                finish(transaction, Status::Exception, exceptionCode, nullptr, 0);
+                break;
+            case ModbusTcpCodec::Result::Malformed:
+                m_errorString = QStringLiteral("响应报文格式错误");
+                finish(transaction, Status::Failed, 0, nullptr, 0);
+                break;
+            }
+
+            // 回调中断开了连接，剩余数据作废
+            if (m_state != QModbusDevice::ConnectedState) {
+                m_rxSize = 0;
+                return;
+            }
+        }
+
+        if (offset > 0) {
+            m_rxSize -= offset;
+            std::memmove(m_rxBuffer.data(), m_rxBuffer.data() + offset, m_rxSize);
+        }
+    }
+}
+
+void ModbusTcpTransport::onDeadline()
+{
+    const qint64 now = m_clock.elapsed();
+    for (Transaction &transaction : m_transactions) {
+        if (transaction.active && transaction.deadlineMs <= now) {
+            m_errorString = QStringLiteral("请求超时");
+            finish(transaction, Status::Timeout, 0, nullptr, 0);
+        }
+    }
+    scheduleDeadline();
+}
+
+void ModbusTcpTransport::scheduleDeadline()
+{
+    qint64 earliest = -1;
+    for (const Transaction &transaction : m_transactions) {
+        if (transaction.active && (earliest < 0 || transaction.deadlineMs < earliest)) {
+            earliest = transaction.deadlineMs;
+        }
+    }
+
+    if (earliest < 0) {
+        m_deadlineTimer->stop();
+        return;
+    }
+    m_deadlineTimer->start(static_cast<int>(qMax<qint64>(0, earliest - m_clock.elapsed())));
+}
+
+void ModbusTcpTransport::finish(Transaction &transaction, Status status, int exceptionCode,
+                                const quint16 *values, int count)
+{
+    // 回调中可能发送新请求，先释放事务
+    const int id = transaction.id;
+    transaction.active = false;
+    m_activeCount--;
+
+    if (m_handler) {
+        m_handler(id, status, exceptionCode, values, count);
+    }
+}
+
+void ModbusTcpTransport::failAll(Status status)
+{
+    for (Transaction &transaction : m_transactions) {
+        if (transaction.active) {
+            finish(transaction, status, 0, nullptr, 0);
+        }
+    }
+    m_deadlineTimer->stop();
+}
+
+void ModbusTcpTransport::onSocketStateChanged(QAbstractSocket::SocketState socketState)
+{
+    switch (socketState) {
+    case QAbstractSocket::HostLookupState:
+    case QAbstractSocket::ConnectingState:
+        setState(QModbusDevice::ConnectingState);
+        break;
+    case QAbstractSocket::ConnectedState:
+        // 请求报文很短，关闭 Nagle 避免与延迟确认叠加造成数十毫秒的等待
+        m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        m_rxSize = 0;
+        setState(QModbusDevice::ConnectedState);
+        break;
+    case QAbstractSocket::ClosingState:
+        setState(QModbusDevice::ClosingState);
+        break;
+    case QAbstractSocket::UnconnectedState:
+        // 先更新状态使回调中的新请求直接失败，再结束在途事务，最后通知
+        m_state = QModbusDevice::UnconnectedState;
+        m_rxSize = 0;
+        if (m_activeCount > 0) {
+            m_errorString = QStringLiteral("连接已断开");
+            failAll(Status::Failed);
+        }
+        emit stateChanged(m_state);
+        break;
+    default:
+        break;
+    }
+}
+
+void ModbusTcpTransport::onSocketError(QAbstractSocket::SocketError)
+{
+    m_errorString = m_socket->errorString();
+    emit errorOccurred(QModbusDevice::ConnectionError);
+}
+
+void ModbusTcpTransport::setState(QModbusDevice::State state)
+{
+    if (m_state == state) {
+        return;
+    }
+    m_state = state;
+    emit stateChanged(state);
+}
@@ -0,0 +1,127 @@
+#ifndef MODBUSTCPTRANSPORT_H
+#define MODBUSTCPTRANSPORT_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QModbusDevice>
+#include <array>
+#include <functional>
+#include "ModbusTcpCodec.h"
+
+/**
+ * @file ModbusTcpTransport.h
+ * @brief 轻量 Modbus TCP 传输层
+ * @description 基于 QTcpSocket 直接收发 ADU，作为 QModbusTcpClient 的替代后端：
+ *              发送与接收缓冲区、事务表、解码输出缓冲区都在构造时预分配，
+ *              稳定运行时每个请求不创建 QModbusReply / QModbusDataUnit，也不分配内存。
+ *              响应按事务 ID 匹配，支持流水线发送；超时由单个定时器按最早截止时刻调度。
+ *              对象与 ModbusManager 同在 I/O 线程中使用。
+ */
+
+class ModbusTcpTransport : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 请求结果
+     */
+    enum class Status {
+        Success,        // 正常响应
+        Exception,      // PLC 返回异常响应
+        Timeout,        // 超时未响应
+        Failed          // 连接断开或响应格式错误
+    };
+
+    /**
+     * @brief 响应回调
+     * @param values 读响应数据，指向传输层内部缓冲区，仅在回调期间有效；其他情况为 nullptr
+     */
+    using ResponseHandler = std::function<void(int transactionId, Status status, int exceptionCode,
+                                               const quint16 *values, int count)>;
+
+    /** 同时在途的最大事务数 */
+    static constexpr int MaxTransactions = 64;
+
+    explicit ModbusTcpTransport(QObject *parent = nullptr);
+
+    /** @brief 设置响应回调（所有请求共用） */
+    void setResponseHandler(ResponseHandler handler) { m_handler = std::move(handler); }
+
+    /** @brief 异步建立连接，结果通过 stateChanged 通知 */
+    void connectDevice(const QString &host, int port);
+
+    /** @brief 断开连接，在途请求全部以 Failed 结束 */
+    void disconnectDevice();
+
+    /** @brief 当前连接状态 */
+    QModbusDevice::State state() const { return m_state; }
+
+    /** @brief 最后一次错误信息 */
+    QString errorString() const { return m_errorString; }
+
+    /**
+     * @brief 发送请求
+     * @description 事务 ID 递增分配，对应槽位仍在途时顺延到下一个空闲槽位
+     * @param function 功能码（ModbusTcpCodec::FunctionCode）
+     * @param values 写请求的数据，读请求为 nullptr
+     * @param timeoutMs 超时时间（毫秒）
+     * @return 事务 ID，未连接、参数非法或 MaxTransactions 个事务全部在途时返回 -1
+     */
+    int send(quint8 unitId, quint8 function, quint16 address, quint16 count, const quint16 *values,
+             int timeoutMs);
+
+signals:
+    void stateChanged(QModbusDevice::State state);
+    void errorOccurred(QModbusDevice::Error error);
+
+private slots:
+    void onSocketStateChanged(QAbstractSocket::SocketState socketState);
+    void onSocketError(QAbstractSocket::SocketError socketError);
+    void onReadyRead();
+    void onDeadline();
+
+private:
+    /**
+     * @brief 在途事务，按事务 ID 对 MaxTransactions 取模存放
+     */
+    struct Transaction {
+        bool active = false;
+        quint16 id = 0;
+        quint8 function = 0;
+        quint16 count = 0;
+        qint64 deadlineMs = 0;
+    };
+
+    /** @brief 结束事务并回调 */
+    void finish(Transaction &transaction, Status status, int exceptionCode, const quint16 *values, int count);
+
+    /** @brief 结束所有在途事务 */
+    void failAll(Status status);
+
+    /** @brief 按最早的截止时刻重新安排超时定时器 */
+    void scheduleDeadline();
+
+    void setState(QModbusDevice::State state);
+
+    QTcpSocket *m_socket;
+    QTimer *m_deadlineTimer;                            // 超时定时器（单次触发）
+    QElapsedTimer m_clock;                              // 截止时刻的时间基准
+    ResponseHandler m_handler;
+    QModbusDevice::State m_state;
+    QString m_errorString;
+
+    std::array<Transaction, MaxTransactions> m_transactions;
+    int m_activeCount;                                  // 在途事务数
+    quint16 m_nextTransactionId;
+
+    // 预分配的缓冲区
+    std::array<quint8, ModbusTcpCodec::MaxAduSize> m_txBuffer;      // 请求 ADU
+    std::array<quint8, 8 * ModbusTcpCodec::MaxAduSize> m_rxBuffer;  // 未处理的接收数据
+    int m_rxSize;                                                   // m_rxBuffer 中的有效字节数
+    std::array<quint16, ModbusTcpCodec::MaxReadBits> m_values;      // 读响应解码输出
+};
+
+#endif // MODBUSTCPTRANSPORT_H
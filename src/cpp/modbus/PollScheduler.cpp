@@ -0,0 +1,240 @@
+#include "PollScheduler.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * @file PollScheduler.cpp
+ * @brief 轮询周期调度器实现
+ */
+
+namespace {
+constexpr qint64 NsPerMs = 1000000;
+
+double toMs(qint64 ns)
+{
+    return static_cast<double>(ns) / NsPerMs;
+}
+}
+
+qint64 PollScheduler::Task::intervalNs() const
+{
+    return static_cast<qint64>(intervalMs) * NsPerMs;
+}
+
+qint64 PollScheduler::Task::skipMissed(qint64 now)
+{
+    // 计划起点之后又过了整周期，说明至少错过了一次，跳过后保持原有相位
+    const qint64 missed = now > deadlineNs ? (now - deadlineNs) / intervalNs() : 0;
+    deadlineNs += missed * intervalNs();
+    skippedCycles += missed;
+    return missed;
+}
+
+PollScheduler::PollScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_running(false)
+    , m_epoch(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &PollScheduler::runNext);
+
+    m_clock.start();
+}
+
+int PollScheduler::addTask(const QString &name, CycleTask task, int intervalMs)
+{
+    Task entry;
+    entry.name = name;
+    entry.run = std::move(task);
+    entry.intervalMs = qMax(1, intervalMs);
+    entry.minDurationNs = std::numeric_limits<qint64>::max();
+    m_tasks.append(entry);
+    return m_tasks.size() - 1;
+}
+
+void PollScheduler::setInterval(int taskId, int intervalMs)
+{
+    m_tasks[taskId].intervalMs = qMax(1, intervalMs);
+}
+
+void PollScheduler::start()
+{
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_epoch++;
+    resetStats();
+
+    const qint64 now = m_clock.nsecsElapsed();
+    for (Task &task : m_tasks) {
+        task.deadlineNs = now;
+    }
+
+    // 上一轮停止前仍在执行的周期由其完成回调接续调度
+    runNext();
+}
+
+void PollScheduler::stop()
+{
+    m_running = false;
+    m_timer->stop();
+}
+
+void PollScheduler::runNext()
+{
+    if (!m_running) {
+        return;
+    }
+
+    // 空闲任务中已到期的按计划起点先后发起，相同时按注册顺序
+    const qint64 now = m_clock.nsecsElapsed();
+    QVector<int> due;
+    qint64 nextDeadlineNs = std::numeric_limits<qint64>::max();
+    for (int i = 0; i < m_tasks.size(); ++i) {
+        const Task &task = m_tasks[i];
+        if (task.inFlight) {
+            continue;
+        }
+        if (task.deadlineNs <= now) {
+            due.append(i);
+        } else {
+            nextDeadlineNs = qMin(nextDeadlineNs, task.deadlineNs);
+        }
+    }
+    std::stable_sort(due.begin(), due.end(), [this](int a, int b) {
+        return m_tasks[a].deadlineNs < m_tasks[b].deadlineNs;
+    });
+    for (int taskId : due) {
+        startCycle(taskId, now);
+    }
+
+    // 定时到空闲任务中最早的计划起点；执行中的任务由完成回调接续
+    if (nextDeadlineNs == std::numeric_limits<qint64>::max()) {
+        m_timer->stop();
+        return;
+    }
+    const qint64 remainingNs = nextDeadlineNs - now;
+    m_timer->start(static_cast<int>((remainingNs + NsPerMs - 1) / NsPerMs));
+}
+
+void PollScheduler::startCycle(int taskId, qint64 now)
+{
+    Task &task = m_tasks[taskId];
+
+    // 周期整周期延误时同样计为跳过
+    task.skipMissed(now);
+
+    task.inFlight = true;
+    task.cycleEpoch = m_epoch;
+    task.cycleStartNs = now;
+    task.lastJitterNs = now - task.deadlineNs;
+
+    QFuture<int> future = task.run ? task.run() : QFuture<int>();
+    if (future.isFinished()) {
+        // 同步完成的周期经事件循环收尾，避免在 runNext 中递归调度
+        QMetaObject::invokeMethod(this, [this, taskId]() {
+            onCycleFinished(taskId);
+        }, Qt::QueuedConnection);
+        return;
+    }
+    // 任务被取消时同样视为周期结束，避免调度停滞
+    future.then(this, [this, taskId](int) {
+        onCycleFinished(taskId);
+    }).onCanceled(this, [this, taskId]() {
+        onCycleFinished(taskId);
+    });
+}
+
+void PollScheduler::onCycleFinished(int taskId)
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    Task &task = m_tasks[taskId];
+    const qint64 duration = now - task.cycleStartNs;
+    task.inFlight = false;
+
+    // 上一轮启动时发起的周期：统计与计划起点已在 start() 中重置，不再计入，
+    // 该任务按重置后的起点立即开始新一轮的首个周期
+    if (task.cycleEpoch != m_epoch) {
+        if (m_running) {
+            runNext();
+        }
+        return;
+    }
+
+    task.cycleCount++;
+    task.lastDurationNs = duration;
+    task.totalDurationNs += duration;
+    task.minDurationNs = qMin(task.minDurationNs, duration);
+    task.maxDurationNs = qMax(task.maxDurationNs, duration);
+    task.totalJitterNs += task.lastJitterNs;
+    task.maxJitterNs = qMax(task.maxJitterNs, task.lastJitterNs);
+
+    // 下一周期起点固定在网格上，不受本周期耗时影响
+    task.deadlineNs += task.intervalNs();
+    if (now > task.deadlineNs) {
+        task.overrunCount++;
+        task.skipMissed(now);
+    }
+
+    if (!m_running) {
+        return;
+    }
+    // 到期的任务立即执行，并重新安排定时器
+    runNext();
+}
+
+QVariantMap PollScheduler::stats() const
+{
+    qint64 cycleCount = 0;
+    qint64 overrunCount = 0;
+    qint64 skippedCycles = 0;
+
+    QVariantMap groups;
+    for (const Task &task : m_tasks) {
+        cycleCount += task.cycleCount;
+        overrunCount += task.overrunCount;
+        skippedCycles += task.skippedCycles;
+
+        const bool hasCycles = task.cycleCount > 0;
+        QVariantMap group;
+        group["intervalMs"] = task.intervalMs;
+        group["cycleCount"] = task.cycleCount;
+        group["overrunCount"] = task.overrunCount;
+        group["skippedCycles"] = task.skippedCycles;
+        group["lastDurationMs"] = toMs(task.lastDurationNs);
+        group["avgDurationMs"] = hasCycles ? toMs(task.totalDurationNs) / task.cycleCount : 0.0;
+        group["minDurationMs"] = hasCycles ? toMs(task.minDurationNs) : 0.0;
+        group["maxDurationMs"] = toMs(task.maxDurationNs);
+        group["lastJitterMs"] = toMs(task.lastJitterNs);
+        group["avgJitterMs"] = hasCycles ? toMs(task.totalJitterNs) / task.cycleCount : 0.0;
+        group["maxJitterMs"] = toMs(task.maxJitterNs);
+        groups.insert(task.name, group);
+    }
+
+    QVariantMap result;
+    result["running"] = m_running;
+    result["cycleCount"] = cycleCount;
+    result["overrunCount"] = overrunCount;
+    result["skippedCycles"] = skippedCycles;
+    result["groups"] = groups;
+    return result;
+}
+
+void PollScheduler::resetStats()
+{
+    for (Task &task : m_tasks) {
+        task.cycleCount = 0;
+        task.overrunCount = 0;
+        task.skippedCycles = 0;
+        task.lastDurationNs = 0;
+        task.totalDurationNs = 0;
+        task.minDurationNs = std::numeric_limits<qint64>::max();
+        task.maxDurationNs = 0;
+        task.lastJitterNs = 0;
+        task.totalJitterNs = 0;
+        task.maxJitterNs = 0;
+    }
+}
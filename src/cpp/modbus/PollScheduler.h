@@ -0,0 +1,118 @@
+#ifndef POLLSCHEDULER_H
+#define POLLSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QVariantMap>
+#include <QVector>
+#include <functional>
+
+/**
+ * @file PollScheduler.h
+ * @brief 轮询周期调度器
+ * @description 按各自周期执行多组异步轮询任务，各组周期相互独立、可以同时在途：
+ *              同一组同一时刻只有一个周期在执行，不同组的请求由 ModbusManager 的优先级队列
+ *              与在途窗口共同限制总线负载，慢周期不会阻塞快周期；
+ *              多组同时到期时按计划起点先后（相同时按注册顺序）发起；
+ *              每组的周期起点按单调时钟对齐到固定网格，不随执行耗时累积漂移；
+ *              周期超时记为超限，被错过的整周期记为跳过，并按组统计耗时与抖动。
+ */
+
+class PollScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 轮询任务
+     * @description 返回本周期的 Future，完成时周期结束；返回已完成的 Future 表示本周期无事可做
+     */
+    using CycleTask = std::function<QFuture<int>()>;
+
+    explicit PollScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief 注册轮询任务
+     * @param name 任务名称（用于统计输出）
+     * @param task 轮询任务
+     * @param intervalMs 轮询周期
+     * @return 任务 ID，注册顺序即同时到期时的优先顺序
+     */
+    int addTask(const QString &name, CycleTask task, int intervalMs);
+
+    /** @brief 设置任务的轮询周期（下一周期生效） */
+    void setInterval(int taskId, int intervalMs);
+    int interval(int taskId) const { return m_tasks[taskId].intervalMs; }
+
+    /**
+     * @brief 启动调度，所有任务立即到期并清空统计
+     * @description 停止前发起、重新启动时仍在执行的周期完成后不计入统计，也不推进计划起点
+     */
+    void start();
+
+    /** @brief 停止调度，执行中的周期完成后不再继续 */
+    void stop();
+
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief 获取周期统计
+     * @return {running, cycleCount, overrunCount, skippedCycles,
+     *          groups: {任务名称: {intervalMs, cycleCount, overrunCount, skippedCycles,
+     *                             lastDurationMs, avgDurationMs, minDurationMs, maxDurationMs,
+     *                             lastJitterMs, avgJitterMs, maxJitterMs}}}
+     */
+    QVariantMap stats() const;
+
+    /** @brief 清空统计 */
+    void resetStats();
+
+private slots:
+    void runNext();
+
+private:
+    /**
+     * @brief 任务状态与统计
+     */
+    struct Task {
+        QString name;
+        CycleTask run;
+        int intervalMs = 100;
+        qint64 deadlineNs = 0;          // 下一周期的计划起点
+        qint64 cycleStartNs = 0;        // 当前周期的实际起点
+        bool inFlight = false;          // 周期执行中
+        quint64 cycleEpoch = 0;         // 当前周期发起时的启动轮次
+
+        qint64 cycleCount = 0;
+        qint64 overrunCount = 0;        // 耗时超过周期的次数
+        qint64 skippedCycles = 0;       // 错过的周期数
+        qint64 lastDurationNs = 0;
+        qint64 totalDurationNs = 0;
+        qint64 minDurationNs = 0;
+        qint64 maxDurationNs = 0;
+        qint64 lastJitterNs = 0;        // 实际起点相对计划起点的延迟
+        qint64 totalJitterNs = 0;
+        qint64 maxJitterNs = 0;
+
+        qint64 intervalNs() const;
+
+        /** @brief 将已错过的整周期跳过，返回跳过数量 */
+        qint64 skipMissed(qint64 now);
+    };
+
+    /** @brief 周期完成：记录统计并安排下一周期 */
+    void onCycleFinished(int taskId);
+
+    /** @brief 发起一个周期 */
+    void startCycle(int taskId, qint64 now);
+
+    QVector<Task> m_tasks;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;          // 单调时钟
+    bool m_running;
+    quint64 m_epoch;                // 启动轮次，每次 start() 递增
+};
+
+#endif // POLLSCHEDULER_H
@@ -0,0 +1,59 @@
+#include "ReadBatch.h"
+#include <algorithm>
+
+/**
+ * @file ReadBatch.cpp
+ * @brief 轮询读取批次实现
+ */
+
+QFuture<void> ReadBatch::start(ModbusManager *manager, const QVector<ReadBlock> &plan,
+                               ModbusManager::RequestPriority priority)
+{
+    if (isRunning()) {
+        return QFuture<void>();
+    }
+
+    // 容量不足时才重新分配，读取计划不变时各轮复用同一段存储
+    m_slots.resize(plan.size());
+    int total = 0;
+    for (int i = 0; i < plan.size(); ++i) {
+        Slot &slot = m_slots[i];
+        slot.offset = total;
+        slot.count = plan[i].count;
+        slot.received = 0;
+        slot.exceptionCode = 0;
+        total += plan[i].count;
+    }
+    m_words.resize(total);
+
+    m_promise = QPromise<void>();
+    m_promise.start();
+    QFuture<void> future = m_promise.future();
+    if (plan.isEmpty()) {
+        m_promise.finish();
+        return future;
+    }
+
+    // 计数先于发送设置，断线时请求会在发送调用中同步完成
+    m_remaining.store(plan.size(), std::memory_order_release);
+    for (int i = 0; i < plan.size(); ++i) {
+        const ReadBlock &block = plan[i];
+        manager->submitRead(block.registerType, block.startAddress, block.count, this, i, 0, priority);
+    }
+    return future;
+}
+
+void ReadBatch::complete(int tag, bool success, const quint16 *values, int count, int exceptionCode)
+{
+    // 各请求写入互不重叠的槽位，由计数的 acq_rel 与 Future 的完成保证对读取方可见
+    Slot &slot = m_slots[tag];
+    if (success && values) {
+        slot.received = qMin(count, slot.count);
+        std::copy(values, values + slot.received, m_words.data() + slot.offset);
+    }
+    slot.exceptionCode = exceptionCode;
+
+    if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_promise.finish();
+    }
+}
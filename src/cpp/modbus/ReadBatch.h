@@ -0,0 +1,63 @@
+#ifndef READBATCH_H
+#define READBATCH_H
+
+#include <QVector>
+#include <QFuture>
+#include <QPromise>
+#include <atomic>
+#include "ModbusManager.h"
+#include "BatchReadPlanner.h"
+
+/**
+ * @file ReadBatch.h
+ * @brief 轮询读取批次
+ * @description 一轮轮询的全部块请求共用一段预分配的结果存储：每个块对应一个槽位，
+ *              响应在 Modbus I/O 线程中直接复制到槽位，全部完成后结束本轮的 Future。
+ *              存储在各轮之间复用，稳定运行时请求路径不再为每个块分配 QPromise、回调或结果列表。
+ *              同一批次同一时刻只能有一轮在途。
+ */
+
+class ReadBatch : public ModbusManager::ResultSink
+{
+public:
+    /**
+     * @brief 发出读取计划中的全部块请求
+     * @param plan 读取计划，槽位序号即块在计划中的序号
+     * @return 全部请求完成时结束的 Future；上一轮尚未完成时返回已取消的 Future
+     */
+    QFuture<void> start(ModbusManager *manager, const QVector<ReadBlock> &plan,
+                        ModbusManager::RequestPriority priority);
+
+    /** @brief 是否有一轮在途 */
+    bool isRunning() const { return m_remaining.load(std::memory_order_acquire) > 0; }
+
+    /** @brief 槽位数量（最近一轮的块数） */
+    int size() const { return m_slots.size(); }
+
+    /** @brief 槽位的读取结果，失败时数量为 0 */
+    const quint16 *values(int slot) const { return m_words.constData() + m_slots[slot].offset; }
+    int valueCount(int slot) const { return m_slots[slot].received; }
+
+    /** @brief 槽位收到的 PLC 异常码，其他情况为 0 */
+    int exceptionCode(int slot) const { return m_slots[slot].exceptionCode; }
+
+    void complete(int tag, bool success, const quint16 *values, int count, int exceptionCode) override;
+
+private:
+    /**
+     * @brief 结果槽位
+     */
+    struct Slot {
+        int offset = 0;             // 在 m_words 中的起始位置
+        int count = 0;              // 请求数量
+        int received = 0;           // 实际收到的数量
+        int exceptionCode = 0;      // 异常码
+    };
+
+    QVector<Slot> m_slots;
+    QVector<quint16> m_words;           // 所有槽位的数据，连续存放
+    std::atomic<int> m_remaining{0};    // 本轮未完成的请求数
+    QPromise<void> m_promise;
+};
+
+#endif // READBATCH_H
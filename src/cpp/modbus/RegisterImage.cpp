@@ -0,0 +1,150 @@
+#include "RegisterImage.h"
+#include "BatchReadPlanner.h"
+#include <QMap>
+#include <algorithm>
+#include <tuple>
+#include <QDebug>
+#include <cstring>
+
+/**
+ * @file RegisterImage.cpp
+ * @brief PLC 寄存器影像实现
+ */
+
+void RegisterImage::build(const SignalTable &table, int gapTolerance, const QVector<bool> &excluded)
+{
+    clear();
+    m_signalBlocks.fill(-1, table.size());
+
+    // (寄存器类型, 分段序号, 窗口序号) -> 窗口内的信号，QMap 保证块按类型和地址升序
+    QMap<std::tuple<int, int, int>, QVector<ReadItem>> windows;
+    for (SignalHandle handle = 0; handle < table.size(); ++handle) {
+        if (!table.isActive(handle) || excluded.value(handle, false)) {
+            continue;
+        }
+        const ModbusManager::RegisterType type = table.registerType(handle);
+        const int address = table.address(handle);
+        if (table.registerCount(handle) > BatchReadPlanner::maxCountPerRead(type)) {
+            // 超出单次读取上限的信号无法整体读取，不纳入影像
+            qWarning() << "信号长度超出单次读取上限，已忽略:" << table.code(handle);
+            continue;
+        }
+        const int windowSize = type == ModbusManager::Coils
+            ? BlockRegisters * BatchReadPlanner::CoilsPerRegister : BlockRegisters;
+
+        ReadItem item;
+        item.registerType = type;
+        item.address = address;
+        item.count = table.registerCount(handle);
+        item.index = handle;
+        windows[std::make_tuple(static_cast<int>(type), segmentOf(type, address), address / windowSize)]
+            .append(item);
+    }
+
+    // 窗口内按间隙容差和单次读取上限再拆分，块不覆盖间隙过大的未配置地址
+    m_blocks.reserve(windows.size());
+    for (auto it = windows.constBegin(); it != windows.constEnd(); ++it) {
+        for (const ReadBlock &span : BatchReadPlanner::plan(it.value(), gapTolerance)) {
+            ImageBlock block;
+            block.registerType = span.registerType;
+            block.startAddress = span.startAddress;
+            block.count = span.count;
+            block.data.fill(0, block.count);
+
+            const int blockId = m_blocks.size();
+            for (const ReadItem &item : span.members) {
+                m_signalBlocks[item.index] = blockId;
+            }
+            m_blocks.append(block);
+        }
+    }
+}
+
+void RegisterImage::addSplitPoint(ModbusManager::RegisterType type, int address)
+{
+    QVector<int> &points = m_splitPoints[static_cast<int>(type)];
+    auto it = std::lower_bound(points.begin(), points.end(), address);
+    if (it == points.end() || *it != address) {
+        points.insert(it, address);
+    }
+}
+
+int RegisterImage::segmentOf(ModbusManager::RegisterType type, int address) const
+{
+    auto it = m_splitPoints.constFind(static_cast<int>(type));
+    if (it == m_splitPoints.constEnd()) {
+        return 0;
+    }
+    return static_cast<int>(std::upper_bound(it->constBegin(), it->constEnd(), address) - it->constBegin());
+}
+
+void RegisterImage::clear()
+{
+    m_blocks.clear();
+    m_signalBlocks.clear();
+}
+
+bool RegisterImage::store(int blockId, const quint16 *data, qint64 nowMs)
+{
+    ImageBlock &block = m_blocks[blockId];
+    const size_t bytes = static_cast<size_t>(block.count) * sizeof(quint16);
+    const bool changed = block.refreshedMs < 0 || std::memcmp(block.data.constData(), data, bytes) != 0;
+    if (changed) {
+        std::memcpy(block.data.data(), data, bytes);
+        block.revision++;
+    }
+    block.refreshedMs = nowMs;
+    return changed;
+}
+
+void RegisterImage::invalidate(ModbusManager::RegisterType type, int address, int count)
+{
+    const int end = address + count;
+    for (ImageBlock &block : m_blocks) {
+        if (block.registerType == type && block.startAddress < end
+            && address < block.startAddress + block.count) {
+            block.refreshedMs = -1;
+        }
+    }
+}
+
+const quint16 *RegisterImage::signalData(const SignalTable &table, SignalHandle handle) const
+{
+    const int blockId = blockOf(handle);
+    if (blockId < 0) {
+        return nullptr;
+    }
+    const ImageBlock &block = m_blocks[blockId];
+    return block.data.constData() + (table.address(handle) - block.startAddress);
+}
+
+QVector<quint16> RegisterImage::read(ModbusManager::RegisterType type, int address, int count,
+                                     qint64 refreshedAfterMs) const
+{
+    if (count <= 0) {
+        return QVector<quint16>();
+    }
+
+    QVector<quint16> result(count);
+    QVector<bool> covered(count, false);
+    int coveredCount = 0;
+
+    const int end = address + count;
+    for (const ImageBlock &block : m_blocks) {
+        if (block.registerType != type || block.refreshedMs < 0 || block.refreshedMs < refreshedAfterMs) {
+            continue;
+        }
+        const int from = qMax(address, block.startAddress);
+        const int to = qMin(end, block.startAddress + block.count);
+        for (int addr = from; addr < to; ++addr) {
+            const int i = addr - address;
+            if (!covered[i]) {
+                covered[i] = true;
+                coveredCount++;
+            }
+            result[i] = block.data[addr - block.startAddress];
+        }
+    }
+
+    return coveredCount == count ? result : QVector<quint16>();
+}
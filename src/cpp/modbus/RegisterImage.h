@@ -0,0 +1,105 @@
+#ifndef REGISTERIMAGE_H
+#define REGISTERIMAGE_H
+
+#include <QVector>
+#include <QHash>
+#include "ModbusManager.h"
+#include "SignalTable.h"
+
+/**
+ * @file RegisterImage.h
+ * @brief PLC 寄存器影像
+ * @description 在内存中镜像信号实际用到的保持寄存器与线圈区间。区间按固定窗口对齐划分，
+ *              窗口内再按地址间隙拆分为块，每块只覆盖信号触及的连续范围，由批量读取整块刷新并记录刷新时刻；
+ *              信号值直接从块数据解码，原始寄存器读取在区间被覆盖且足够新时由影像应答。
+ */
+
+/**
+ * @brief 影像块
+ */
+struct ImageBlock {
+    ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;  // 寄存器类型
+    int startAddress = 0;       // 块起始地址
+    int count = 0;              // 块长度（寄存器/线圈数）
+    QVector<quint16> data;      // 块数据，线圈每个元素 0/1
+    qint64 refreshedMs = -1;    // 最近一次刷新时刻（单调时钟毫秒），从未刷新或已失效为 -1
+    quint64 revision = 0;       // 数据版本，块数据发生变化时递增
+};
+
+class RegisterImage
+{
+public:
+    /** 块对齐窗口（寄存器数），线圈按 BlockRegisters * 16 个线圈对齐 */
+    static constexpr int BlockRegisters = 64;
+
+    /**
+     * @brief 按信号表中的活跃信号重建影像块
+     * @description 信号归属其起始地址所在窗口，窗口内的信号按地址间隙容差拆分为块，
+     *              块长度不超过单次读取上限（125 个寄存器 / 2000 个线圈）；
+     *              跨越窗口边界的多寄存器信号使块略微超出窗口；块不会跨越分割点
+     * @param gapTolerance 块内允许的地址间隙（寄存器数），线圈按 16 倍计算
+     * @param excluded 句柄 -> 是否排除（被隔离的信号），为空时不排除
+     */
+    void build(const SignalTable &table, int gapTolerance, const QVector<bool> &excluded = QVector<bool>());
+
+    /**
+     * @brief 添加分割点
+     * @description 分割点两侧的地址单独读取时正常、合并读取时被 PLC 拒绝（中间存在非法地址），
+     *              重建后的块以及合并后的读取请求都不会跨越分割点
+     * @param address 分割点右侧区间的起始地址
+     */
+    void addSplitPoint(ModbusManager::RegisterType type, int address);
+
+    /** @brief 清除所有分割点（信号配置重新加载时） */
+    void clearSplitPoints() { m_splitPoints.clear(); }
+
+    /** @brief 地址所在的分段序号（该类型中不大于地址的分割点数量），序号不同的地址不能合并读取 */
+    int segmentOf(ModbusManager::RegisterType type, int address) const;
+
+    /** @brief 清空影像 */
+    void clear();
+
+    /** @brief 块数量 */
+    int blockCount() const { return m_blocks.size(); }
+
+    /** @brief 获取块 */
+    const ImageBlock &block(int blockId) const { return m_blocks[blockId]; }
+
+    /** @brief 信号所在的块，未纳入影像（非活跃信号）时返回 -1 */
+    int blockOf(SignalHandle handle) const { return m_signalBlocks.value(handle, -1); }
+
+    /**
+     * @brief 用读取结果刷新整块
+     * @description 与现有块数据逐字节比较，相同时只刷新时刻；首次刷新或失效后的刷新总是视为变化
+     * @param data 块数据，长度为块长度
+     * @return 块数据是否变化（变化时 revision 递增）
+     */
+    bool store(int blockId, const quint16 *data, qint64 nowMs);
+
+    /**
+     * @brief 使与区间重叠的块失效
+     * @description 写入后块数据与 PLC 不再一致，在下一次刷新前不再用于应答原始读取
+     */
+    void invalidate(ModbusManager::RegisterType type, int address, int count);
+
+    /**
+     * @brief 获取信号在块数据中的起始位置
+     * @return 信号数据指针，信号未纳入影像时返回 nullptr
+     */
+    const quint16 *signalData(const SignalTable &table, SignalHandle handle) const;
+
+    /**
+     * @brief 从影像读取原始数据
+     * @param refreshedAfterMs 只使用在该时刻之后刷新过的块
+     * @return 区间完全被满足条件的块覆盖时返回数据，否则返回空
+     */
+    QVector<quint16> read(ModbusManager::RegisterType type, int address, int count,
+                          qint64 refreshedAfterMs) const;
+
+private:
+    QVector<ImageBlock> m_blocks;           // 按寄存器类型和地址升序
+    QVector<int> m_signalBlocks;            // 句柄 -> 块 ID
+    QHash<int, QVector<int>> m_splitPoints; // 寄存器类型 -> 分割点（升序）
+};
+
+#endif // REGISTERIMAGE_H
@@ -0,0 +1,168 @@
+#include "SignalCodec.h"
+#include "ModbusSignal.h"
+#include <cmath>
+#include <cstring>
+
+/**
+ * @file SignalCodec.cpp
+ * @brief 信号编解码器实现
+ */
+
+SignalDecodeSpec SignalCodec::compile(const ModbusSignal &signal)
+{
+    SignalDecodeSpec spec;
+    const QString dataType = signal.dataType.toLower();
+
+    // 与老项目保持一致：线圈使用 registerAddress，保持寄存器使用 offsetValue
+    if (signal.registerType == "1") {
+        spec.registerType = ModbusManager::Coils;
+        spec.address = signal.registerAddress;
+    } else {
+        spec.registerType = ModbusManager::HoldingRegisters;
+        spec.address = signal.offsetValue;
+    }
+
+    // 保持寄存器可按位引用：与同一寄存器的其他位信号共用一次读取
+    const bool bitInWord = spec.registerType == ModbusManager::HoldingRegisters
+        && signal.bitIndex >= 0 && signal.bitIndex < 16;
+    if (bitInWord) {
+        spec.bitIndex = static_cast<quint8>(signal.bitIndex);
+    }
+
+    spec.registerCount = bitInWord ? 1 : static_cast<quint8>(qBound(1, signal.registerCount, 255));
+    spec.scaled = signal.scaleFactor > 0;
+    spec.scaleDivisor = spec.scaled ? std::pow(10.0, signal.scaleFactor) : 1.0;
+    spec.writable = signal.signalType == "write";
+    spec.active = signal.isActive;
+
+    // 解码：按位引用优先，其次根据 registerCount 决定处理方式
+    if (bitInWord) {
+        spec.decodeKind = DecodeKind::BitInWord;
+    } else if (dataType == "bit") {
+        spec.decodeKind = DecodeKind::Bit;
+    } else if (signal.registerCount == 1) {
+        spec.decodeKind = spec.scaled ? DecodeKind::UInt16Scaled : DecodeKind::UInt16;
+    } else if (signal.registerCount == 2) {
+        spec.decodeKind = DecodeKind::Float32;
+        spec.wordOrder = WordOrder::LowWordFirst;
+    } else if (signal.registerCount == 4) {
+        spec.decodeKind = dataType == "double" ? DecodeKind::Float64 : DecodeKind::Int64;
+        spec.wordOrder = WordOrder::HighWordFirst;
+    } else {
+        spec.decodeKind = DecodeKind::Raw;
+    }
+
+    // 编码：根据 dataType 决定处理方式
+    if (bitInWord) {
+        spec.encodeKind = EncodeKind::BitInWord;
+    } else if (dataType == "bit") {
+        spec.encodeKind = EncodeKind::Bit;
+    } else if (dataType == "word" || dataType == "uint16") {
+        spec.encodeKind = EncodeKind::Word;
+    } else if (dataType == "float") {
+        spec.encodeKind = EncodeKind::Float32;
+    } else {
+        spec.encodeKind = EncodeKind::Integer;
+    }
+
+    return spec;
+}
+
+QVariant SignalCodec::decode(const SignalDecodeSpec &spec, const quint16 *raw, int count)
+{
+    if (count <= 0) {
+        return QVariant();
+    }
+
+    switch (spec.decodeKind) {
+    case DecodeKind::Bit:
+        return raw[0] != 0;
+
+    case DecodeKind::BitInWord:
+        return ((raw[0] >> spec.bitIndex) & 1) != 0;
+
+    case DecodeKind::UInt16:
+        return static_cast<int>(raw[0]);
+
+    case DecodeKind::UInt16Scaled:
+        // scaleFactor 表示小数位数，例如 scaleFactor=3 表示除以 1000
+        return raw[0] / spec.scaleDivisor;
+
+    case DecodeKind::Float32: {
+        if (count < 2) {
+            return static_cast<int>(raw[0]);
+        }
+        // 与老项目保持一致：shortData[1] << 16 | shortData[0]
+        const quint32 combined = (static_cast<quint32>(raw[1]) << 16) | raw[0];
+        float floatVal;
+        std::memcpy(&floatVal, &combined, sizeof(float));
+        return static_cast<double>(floatVal);
+    }
+
+    case DecodeKind::Float64:
+    case DecodeKind::Int64: {
+        if (count < 4) {
+            return static_cast<int>(raw[0]);
+        }
+        const qint64 longBits = (static_cast<qint64>(raw[0]) << 48) |
+                                (static_cast<qint64>(raw[1]) << 32) |
+                                (static_cast<qint64>(raw[2]) << 16) |
+                                static_cast<qint64>(raw[3]);
+        if (spec.decodeKind == DecodeKind::Float64) {
+            double doubleVal;
+            std::memcpy(&doubleVal, &longBits, sizeof(double));
+            return doubleVal;
+        }
+        return longBits;
+    }
+
+    case DecodeKind::Raw:
+        break;
+    }
+
+    // 默认返回第一个值
+    return static_cast<int>(raw[0]);
+}
+
+QVector<quint16> SignalCodec::encode(const SignalDecodeSpec &spec, const QVariant &value,
+                                     quint16 currentWord)
+{
+    QVector<quint16> result;
+
+    switch (spec.encodeKind) {
+    case EncodeKind::Bit:
+        result.append(value.toBool() ? 1 : 0);
+        break;
+
+    case EncodeKind::BitInWord: {
+        const quint16 mask = static_cast<quint16>(1u << spec.bitIndex);
+        result.append(value.toBool() ? (currentWord | mask) : (currentWord & ~mask));
+        break;
+    }
+
+    case EncodeKind::Word: {
+        // 与读取逻辑保持一致：写入时需要乘以 10^scaleFactor 还原为原始值
+        const double val = value.toDouble();
+        const int raw = spec.scaled ? static_cast<int>(val * spec.scaleDivisor)
+                                    : static_cast<int>(val);
+        result.append(static_cast<quint16>(raw));
+        break;
+    }
+
+    case EncodeKind::Float32: {
+        // Little Endian word order（低位字在前），与读取保持一致
+        const float floatVal = static_cast<float>(value.toDouble());
+        quint32 combined;
+        std::memcpy(&combined, &floatVal, sizeof(float));
+        result.append(static_cast<quint16>(combined & 0xFFFF));  // 低位字先添加
+        result.append(static_cast<quint16>(combined >> 16));     // 高位字后添加
+        break;
+    }
+
+    case EncodeKind::Integer:
+        result.append(static_cast<quint16>(value.toInt()));
+        break;
+    }
+
+    return result;
+}
@@ -0,0 +1,94 @@
+#ifndef SIGNALCODEC_H
+#define SIGNALCODEC_H
+
+#include <QVariant>
+#include <QVector>
+#include "ModbusManager.h"
+
+struct ModbusSignal;
+
+/**
+ * @file SignalCodec.h
+ * @brief 信号编解码器
+ * @description 在加载信号配置时将 ModbusSignal 预编译为紧凑的解码描述符，
+ *              轮询热路径只对 POD 结构做 switch 分派，不再进行字符串比较和 pow 运算
+ */
+
+/**
+ * @brief 解码类型（由 registerCount 与 dataType 预先确定）
+ */
+enum class DecodeKind : quint8 {
+    Bit,            // 位：首个值非零即为 true
+    BitInWord,      // 保持寄存器中的单个位
+    UInt16,         // 单寄存器无符号整数
+    UInt16Scaled,   // 单寄存器无符号整数，除以 10^scaleFactor
+    Float32,        // 双寄存器浮点数
+    Float64,        // 四寄存器双精度浮点数
+    Int64,          // 四寄存器长整数
+    Raw             // 其他：返回首个寄存器值
+};
+
+/**
+ * @brief 编码类型（由 dataType 预先确定，与旧版写入逻辑保持一致）
+ */
+enum class EncodeKind : quint8 {
+    Bit,            // 位：0/1
+    BitInWord,      // 保持寄存器中的单个位：在寄存器当前值上置位或清位
+    Word,           // 16 位整数，乘以 10^scaleFactor
+    Float32,        // 32 位浮点数
+    Integer         // 默认按整数写入单个寄存器
+};
+
+/**
+ * @brief 多寄存器数据的字序
+ */
+enum class WordOrder : quint8 {
+    LowWordFirst,   // 低位字在前（float：shortData[1] << 16 | shortData[0]）
+    HighWordFirst   // 高位字在前（double/int64：raw[0] << 48 ...）
+};
+
+/**
+ * @brief 信号解码描述符
+ */
+struct SignalDecodeSpec {
+    ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;  // 已解析的寄存器类型
+    int address = 0;                // 已解析的 Modbus 地址
+    quint8 registerCount = 1;       // 寄存器数量
+    DecodeKind decodeKind = DecodeKind::Raw;
+    EncodeKind encodeKind = EncodeKind::Integer;
+    WordOrder wordOrder = WordOrder::LowWordFirst;
+    bool scaled = false;            // 是否存在比例因子
+    bool writable = false;          // 是否可写
+    bool active = true;             // 是否启用
+    quint8 bitIndex = 0;            // BitInWord 的位序号
+    double scaleDivisor = 1.0;      // 10^scaleFactor，加载时预先计算
+};
+
+class SignalCodec
+{
+public:
+    /**
+     * @brief 将信号配置编译为解码描述符
+     * @description 与老项目保持一致：线圈使用 registerAddress，保持寄存器使用 offsetValue
+     */
+    static SignalDecodeSpec compile(const ModbusSignal &signal);
+
+    /**
+     * @brief 从原始寄存器数据解码信号值
+     * @param spec 解码描述符
+     * @param raw 指向该信号首个寄存器的指针
+     * @param count 可用寄存器数量
+     * @return 转换后的值，数据不足时返回无效 QVariant
+     */
+    static QVariant decode(const SignalDecodeSpec &spec, const quint16 *raw, int count);
+
+    /**
+     * @brief 将实际值编码为原始寄存器数据
+     * @param currentWord 寄存器当前值，仅 BitInWord 使用：其余位保持不变
+     * @return 寄存器值列表，线圈为 0/1
+     */
+    static QVector<quint16> encode(const SignalDecodeSpec &spec, const QVariant &value,
+                                   quint16 currentWord = 0);
+};
+
+#endif // SIGNALCODEC_H
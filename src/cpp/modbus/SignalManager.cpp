@@ -1,8 +1,8 @@
 #include "SignalManager.h"
 #include "ModbusManager.h"
 #include "PlcAddressMapper.h"
-#include <QtEndian>
-#include <cmath>
+#include <QMap>
+#include <algorithm>
 
 /**
  * @file SignalManager.cpp
@@ -15,18 +15,37 @@ SignalManager::SignalManager(ModbusManager *modbusManager,
     : QObject(parent)
     , m_modbusManager(modbusManager)
     , m_addressMapper(addressMapper)
+    , m_generation(0)
+    , m_planVersion(0)
+    , m_staleAfterMs(10000)
+    , m_readGapTolerance(8)
+    , m_activePlanDirty(true)
+    , m_isolatingFaults(false)
+    , m_nextSubscriptionId(1)
+    , m_writeTail(QtFuture::makeReadyVoidFuture())
 {
+    m_clock.start();
 }
 
 void SignalManager::loadSignals(const QList<ModbusSignal> &signalList)
 {
-    m_signals.clear();
-    for (const ModbusSignal &signal : signalList) {
-        if (!signal.signalCode.isEmpty()) {
-            m_signals[signal.signalCode] = signal;
-        }
+    // 重建信号表并预编译解码描述符，轮询时不再解析字符串
+    m_table.rebuild(signalList);
+    m_quarantined.fill(false, m_table.size());
+    m_image.clearSplitPoints();
+    m_image.build(m_table, m_readGapTolerance);
+    m_generation++;
+    m_activePlanDirty = true;
+    resolvePollClasses();
+
+    // 句柄已重新分配，按新配置重新解析所有订阅
+    m_refCounts.fill(0, m_table.size());
+    for (Subscription &subscription : m_subscriptions) {
+        subscription.handles = resolveSubscription(subscription);
+        retainHandles(subscription.handles);
     }
-    emit signalsLoaded(m_signals.size());
+
+    emit signalsLoaded(m_table.size());
 }
 
 void SignalManager::loadSignalsFromJson(const QVariantList &jsonArray)
@@ -46,10 +65,18 @@ void SignalManager::loadSignalsFromJson(const QVariantList &jsonArray)
         signal.registerCount = map.value("registerCount", 1).toInt();
         signal.scaleFactor = map.value("scaleFactor", 1).toInt();
         signal.offsetValue = map.value("offsetValue", 0).toInt();
+        // 未设置的 Integer 字段在 ERP 中序列化为 null，toInt() 会得到 0，误判为第 0 位
+        const QVariant bitIndex = map.value("bitIndex");
+        bool bitIndexOk = false;
+        const int bit = bitIndex.toInt(&bitIndexOk);
+        signal.bitIndex = (bitIndex.isNull() || !bitIndexOk) ? -1 : bit;
         signal.unit = map.value("unit").toString();
         signal.plcAreaType = map.value("plcAreaType").toString();
         signal.paramGroup = map.value("paramGroup").toString();
         signal.isActive = map.value("isActive", true).toBool();
+        signal.deadband = map.value("deadband", 0.0).toDouble();
+        signal.deadbandPercent = map.value("deadbandType").toString() == QLatin1String("percent");
+        signal.minReportInterval = map.value("minReportInterval", 0).toInt();
         signalList.append(signal);
     }
     loadSignals(signalList);
@@ -57,13 +84,14 @@ void SignalManager::loadSignalsFromJson(const QVariantList &jsonArray)
 
 ModbusSignal SignalManager::getSignal(const QString &signalCode) const
 {
-    return m_signals.value(signalCode);
+    const SignalHandle handle = m_table.handleOf(signalCode);
+    return m_table.isValid(handle) ? m_table.signal(handle) : ModbusSignal();
 }
 
 QList<ModbusSignal> SignalManager::getSignalsByGroup(const QString &paramGroup) const
 {
     QList<ModbusSignal> result;
-    for (const ModbusSignal &signal : m_signals) {
+    for (const ModbusSignal &signal : m_table.allSignals()) {
         if (signal.paramGroup == paramGroup) {
             result.append(signal);
         }
@@ -73,207 +101,977 @@ QList<ModbusSignal> SignalManager::getSignalsByGroup(const QString &paramGroup)
 
 void SignalManager::clearSignals()
 {
-    m_signals.clear();
+    m_table.clear();
+    m_quarantined.clear();
+    m_image.clear();
+    m_image.clearSplitPoints();
+    m_generation++;
+    m_activePlanDirty = true;
+
+    m_refCounts.clear();
+    m_pollClasses.clear();
+    for (Subscription &subscription : m_subscriptions) {
+        subscription.handles.clear();
+    }
+}
+
+int SignalManager::addSubscription(const QStringList &signalCodes, const QStringList &paramGroups)
+{
+    Subscription subscription;
+    subscription.signalCodes = signalCodes;
+    subscription.paramGroups = paramGroups;
+    subscription.handles = resolveSubscription(subscription);
+    retainHandles(subscription.handles);
+
+    const int subscriptionId = m_nextSubscriptionId++;
+    m_subscriptions.insert(subscriptionId, subscription);
+    return subscriptionId;
+}
+
+bool SignalManager::removeSubscription(int subscriptionId)
+{
+    auto it = m_subscriptions.find(subscriptionId);
+    if (it == m_subscriptions.end()) {
+        return false;
+    }
+    releaseHandles(it->handles);
+    m_subscriptions.erase(it);
+    return true;
 }
 
-QVariant SignalManager::readSignalValue(const QString &signalCode)
+QVector<SignalHandle> SignalManager::resolveSubscription(const Subscription &subscription) const
 {
-    if (!m_signals.contains(signalCode)) {
+    QVector<SignalHandle> handles;
+    QVector<bool> seen(m_table.size(), false);
+
+    auto addHandle = [&handles, &seen](SignalHandle handle) {
+        if (!seen[handle]) {
+            seen[handle] = true;
+            handles.append(handle);
+        }
+    };
+
+    for (const QString &code : subscription.signalCodes) {
+        const SignalHandle handle = m_table.handleOf(code);
+        if (handle != SignalTable::InvalidHandle) {
+            addHandle(handle);
+        }
+    }
+
+    if (!subscription.paramGroups.isEmpty()) {
+        for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+            if (subscription.paramGroups.contains(m_table.signal(handle).paramGroup)) {
+                addHandle(handle);
+            }
+        }
+    }
+    return handles;
+}
+
+void SignalManager::retainHandles(const QVector<SignalHandle> &handles)
+{
+    for (SignalHandle handle : handles) {
+        if (m_refCounts[handle]++ == 0) {
+            // 重新被订阅的信号前端可能没有最新值，首次轮询即推送
+            m_table.forceReport(handle);
+            m_activePlanDirty = true;
+        }
+    }
+}
+
+void SignalManager::releaseHandles(const QVector<SignalHandle> &handles)
+{
+    for (SignalHandle handle : handles) {
+        if (--m_refCounts[handle] == 0) {
+            m_activePlanDirty = true;
+        }
+    }
+}
+
+void SignalManager::setReadGapTolerance(int registers)
+{
+    m_readGapTolerance = qMax(0, registers);
+
+    // 影像块按间隙容差拆分，重建后块 ID 改变，在途的轮询结果随计划版本一起作废
+    m_image.build(m_table, m_readGapTolerance, m_quarantined);
+    m_planVersion++;
+    m_activePlanDirty = true;
+}
+
+QFuture<QVariant> SignalManager::readSignalValue(const QString &signalCode, int maxAgeMs)
+{
+    const SignalHandle handle = m_table.handleOf(signalCode);
+    if (handle == SignalTable::InvalidHandle) {
         emit errorOccurred(QStringLiteral("信号不存在: %1").arg(signalCode));
-        return QVariant();
+        return QtFuture::makeReadyValueFuture(QVariant());
     }
 
-    const ModbusSignal &signal = m_signals[signalCode];
-    if (!signal.isActive) {
-        return QVariant();
+    if (!m_table.isActive(handle)) {
+        return QtFuture::makeReadyValueFuture(QVariant());
     }
 
-    // 根据寄存器类型选择读取方法
-    // 与老项目保持一致：线圈使用 registerAddress，保持寄存器使用 offsetValue
-    QVariantList rawValues;
-    if (signal.registerType == "1") {
-        // 线圈 - 使用 registerAddress
-        rawValues = m_modbusManager->readCoils(signal.registerAddress, signal.registerCount);
-    } else {
-        // 保持寄存器（默认）- 使用 offsetValue 作为地址
-        rawValues = m_modbusManager->readHoldingRegisters(signal.offsetValue, signal.registerCount);
+    if (isCacheFresh(handle, maxAgeMs)) {
+        return QtFuture::makeReadyValueFuture(m_table.value(handle));
+    }
+
+    // 与批量读取一样按影像块读取，结果同时刷新影像与缓存
+    return optimizedBatchRead({handle}).then([signalCode](const QVariantMap &values) {
+        return values.value(signalCode);
+    });
+}
+
+QFuture<QVariantMap> SignalManager::readSignalValues(const QStringList &signalCodes, int maxAgeMs)
+{
+    QVariantMap result;
+    QVector<SignalHandle> handles;
+    handles.reserve(signalCodes.size());
+    for (const QString &code : signalCodes) {
+        const SignalHandle handle = m_table.handleOf(code);
+        if (handle == SignalTable::InvalidHandle) {
+            emit errorOccurred(QStringLiteral("信号不存在: %1").arg(code));
+            continue;
+        }
+        if (!m_table.isActive(handle)) {
+            continue;
+        }
+        // 缓存足够新的信号直接返回，其余合并为批量读取
+        if (isCacheFresh(handle, maxAgeMs)) {
+            result.insert(code, m_table.value(handle));
+        } else {
+            handles.append(handle);
+        }
     }
 
-    if (rawValues.isEmpty()) {
-        return QVariant();
+    if (handles.isEmpty()) {
+        return QtFuture::makeReadyValueFuture(result);
     }
+    return optimizedBatchRead(handles).then([result](const QVariantMap &values) {
+        QVariantMap merged = result;
+        merged.insert(values);
+        return merged;
+    });
+}
 
-    return convertFromRaw(signal, rawValues);
+bool SignalManager::isCacheFresh(SignalHandle handle, int maxAgeMs) const
+{
+    if (maxAgeMs <= 0) {
+        return false;
+    }
+    const qint64 nowMs = m_clock.elapsed();
+    return m_table.quality(handle, nowMs, m_staleAfterMs) == SignalQuality::Good
+        && nowMs - m_table.updatedAt(handle) <= maxAgeMs;
 }
 
-QVariantMap SignalManager::readSignalValues(const QStringList &signalCodes)
+QVariantMap SignalManager::cachedValues(const QStringList &signalCodes) const
 {
+    const qint64 nowMs = m_clock.elapsed();
+
     QVariantMap result;
     for (const QString &code : signalCodes) {
-        QVariant value = readSignalValue(code);
-        if (value.isValid()) {
-            result[code] = value;
+        const SignalHandle handle = m_table.handleOf(code);
+        if (handle == SignalTable::InvalidHandle) {
+            continue;
         }
+        const qint64 updatedAt = m_table.updatedAt(handle);
+
+        QVariantMap entry;
+        entry["value"] = m_table.value(handle);
+        entry["quality"] = qualityName(m_table.quality(handle, nowMs, m_staleAfterMs));
+        entry["ageMs"] = updatedAt < 0 ? qint64(-1) : nowMs - updatedAt;
+        result.insert(code, entry);
     }
     return result;
 }
 
-QVariantMap SignalManager::readAllActiveSignals()
+SignalQuality SignalManager::qualityOf(SignalHandle handle) const
 {
-    QList<ModbusSignal> activeSignals;
-    for (const ModbusSignal &signal : m_signals) {
-        // 读取所有活跃信号，不再限制 signalType
-        // write 类型信号虽然用于下发指令，但其当前值也需要在 UI 上显示
-        if (signal.isActive) {
-            activeSignals.append(signal);
+    return m_table.quality(handle, m_clock.elapsed(), m_staleAfterMs);
+}
+
+QString SignalManager::qualityName(SignalQuality quality)
+{
+    switch (quality) {
+    case SignalQuality::Good:
+        return QStringLiteral("good");
+    case SignalQuality::CommError:
+        return QStringLiteral("commError");
+    default:
+        return QStringLiteral("stale");
+    }
+}
+
+QFuture<QVariantMap> SignalManager::readAllActiveSignals()
+{
+    QVector<SignalHandle> handles;
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        if (m_table.isActive(handle) && m_refCounts[handle] > 0) {
+            handles.append(handle);
         }
     }
-    return optimizedBatchRead(activeSignals);
+    return optimizedBatchRead(handles);
 }
 
-bool SignalManager::writeSignalValue(const QString &signalCode, const QVariant &value)
+QVector<quint16> SignalManager::readImage(ModbusManager::RegisterType type, int address, int count) const
 {
-    if (!m_signals.contains(signalCode)) {
-        emit errorOccurred(QStringLiteral("信号不存在: %1").arg(signalCode));
-        return false;
+    return m_image.read(type, address, count, m_clock.elapsed() - m_staleAfterMs);
+}
+
+QFuture<int> SignalManager::pollActiveSignalsAsync(PollClass pollClass)
+{
+    ensureActivePlan();
+
+    const QVector<ReadBlock> plan = m_activePlans[pollClass];
+    const quint64 generation = m_generation;
+    const quint64 planVersion = m_planVersion;
+    if (plan.isEmpty()) {
+        return QFuture<int>();
     }
 
-    const ModbusSignal &signal = m_signals[signalCode];
-    if (signal.signalType != "write") {
-        emit errorOccurred(QStringLiteral("信号不可写: %1").arg(signalCode));
-        return false;
+    // 所有块请求一次性发出，由 ModbusManager 异步完成，互不阻塞；
+    // 快速等级优先于常规、慢速等级，操作命令总是优先于轮询
+    // 结果直接写入本等级预分配的批次存储，全部完成后在本线程统一处理
+    const ModbusManager::RequestPriority priority =
+        pollClass == FastPoll ? ModbusManager::FastPollPriority : ModbusManager::BackgroundPriority;
+    return m_pollBatches[pollClass].start(m_modbusManager, plan, priority)
+        .then(this, [this, plan, generation, planVersion, pollClass]() {
+            // 读取期间重新加载了配置或修复了读取计划，块 ID 已失效，丢弃本轮结果
+            if (generation != m_generation || planVersion != m_planVersion) {
+                return 0;
+            }
+
+            // 先刷新影像块，筛选出需要解码的信号后整轮批量解码
+            const ReadBatch &batch = m_pollBatches[pollClass];
+            const qint64 nowMs = m_clock.elapsed();
+            QVector<SignalHandle> pending;
+            for (int i = 0; i < plan.size(); ++i) {
+                const bool ok = storeResponse(plan[i], batch.values(i), batch.valueCount(i), nowMs);
+                for (const ReadItem &item : plan[i].members) {
+                    collectSignals(pollClass, item.index, ok, nowMs, pending);
+                }
+                if (batch.exceptionCode(i) != 0) {
+                    scheduleFaultIsolation(plan[i]);
+                }
+            }
+
+            QVector<QVariant> values;
+            m_decoder.decode(m_table, m_image, pending, values);
+
+            QVector<SignalHandle> changed;
+            for (int i = 0; i < pending.size(); ++i) {
+                if (values[i].isValid() && m_table.updateValue(pending[i], values[i], nowMs)) {
+                    changed.append(pending[i]);
+                }
+            }
+
+            // 只通知本轮变化的信号，推送格式由接收方决定
+            if (!changed.isEmpty()) {
+                emit signalValuesChanged(changed);
+            }
+            return static_cast<int>(changed.size());
+        });
+}
+
+QVariantMap SignalManager::valuesOf(const QVector<SignalHandle> &handles) const
+{
+    QVariantMap result;
+    for (SignalHandle handle : handles) {
+        result.insert(m_table.code(handle), m_table.value(handle));
     }
+    return result;
+}
 
-    QVariantList rawValues = convertToRaw(signal, value);
-    if (rawValues.isEmpty()) {
-        return false;
+QVector<SignalHandle> SignalManager::valuedHandles() const
+{
+    QVector<SignalHandle> handles;
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        if (m_table.value(handle).isValid()) {
+            handles.append(handle);
+        }
+    }
+    return handles;
+}
+
+QVariantMap SignalManager::currentValues() const
+{
+    QVariantMap result;
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        const QVariant &value = m_table.value(handle);
+        if (value.isValid()) {
+            result.insert(m_table.code(handle), value);
+        }
+    }
+    return result;
+}
+
+void SignalManager::ensureActivePlan()
+{
+    if (!m_activePlanDirty) {
+        return;
     }
 
-    if (signal.registerType == "1") {
-        // 线圈 - 使用 registerAddress
-        return m_modbusManager->writeCoils(signal.registerAddress, rawValues);
+    // 只读取被视图订阅的活跃信号，不再限制 signalType
+    // write 类型信号虽然用于下发指令，但其当前值也需要在 UI 上显示
+    QVector<SignalHandle> handles[PollClassCount];
+    for (int pollClass = 0; pollClass < PollClassCount; ++pollClass) {
+        m_blockMembers[pollClass] = QVector<QVector<SignalHandle>>(m_image.blockCount());
+        m_decodedRevisions[pollClass].fill(0, m_image.blockCount());
+    }
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        // 被隔离的信号不在影像中，不再读取
+        const int blockId = m_image.blockOf(handle);
+        if (blockId >= 0 && m_refCounts[handle] > 0) {
+            const int pollClass = m_pollClasses[handle];
+            handles[pollClass].append(handle);
+            m_blockMembers[pollClass][blockId].append(handle);
+        }
+    }
+    for (int pollClass = 0; pollClass < PollClassCount; ++pollClass) {
+        m_activePlans[pollClass] = buildReadPlan(handles[pollClass]);
+    }
+    m_activePlanDirty = false;
+}
+
+void SignalManager::setGroupPollClass(const QString &paramGroup, PollClass pollClass)
+{
+    m_groupPollClasses.insert(paramGroup, pollClass);
+    resolvePollClasses();
+}
+
+void SignalManager::setGroupPollClasses(const QVariantMap &groupClasses)
+{
+    m_groupPollClasses.clear();
+    for (auto it = groupClasses.constBegin(); it != groupClasses.constEnd(); ++it) {
+        m_groupPollClasses.insert(it.key(), pollClassFromName(it.value().toString()));
     }
-    // 保持寄存器 - 使用 offsetValue
-    return m_modbusManager->writeRegisters(signal.offsetValue, rawValues);
+    resolvePollClasses();
 }
 
-QVariant SignalManager::convertFromRaw(const ModbusSignal &signal, const QVariantList &rawValues)
+void SignalManager::resolvePollClasses()
 {
-    if (rawValues.isEmpty()) {
-        return QVariant();
+    m_pollClasses.resize(m_table.size());
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        m_pollClasses[handle] = static_cast<quint8>(
+            m_groupPollClasses.value(m_table.signal(handle).paramGroup, NormalPoll));
     }
+    m_activePlanDirty = true;
+}
 
-    QString dataType = signal.dataType.toLower();
-    int registerCount = signal.registerCount;
+QString SignalManager::pollClassName(PollClass pollClass)
+{
+    switch (pollClass) {
+    case FastPoll:
+        return QStringLiteral("fast");
+    case SlowPoll:
+        return QStringLiteral("slow");
+    default:
+        return QStringLiteral("normal");
+    }
+}
 
-    // 位类型
-    if (dataType == "bit") {
-        return rawValues.first().toBool();
+SignalManager::PollClass SignalManager::pollClassFromName(const QString &name, PollClass fallback)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == QLatin1String("fast")) {
+        return FastPoll;
+    }
+    if (key == QLatin1String("normal")) {
+        return NormalPoll;
     }
+    if (key == QLatin1String("slow")) {
+        return SlowPoll;
+    }
+    return fallback;
+}
 
-    // 与老项目保持一致：优先根据 registerCount 决定处理方式
-    // registerCount == 1: 单寄存器（word/uint16）
-    // registerCount == 2: 双寄存器（float）
-    // registerCount == 4: 四寄存器（double）
+QFuture<bool> SignalManager::writeSignalValue(const QString &signalCode, const QVariant &value)
+{
+    // 与批量写入共用校验、编码与按位改写流程
+    QVariantMap values;
+    values.insert(signalCode, value);
+    return writeSignalValues(values).then([signalCode](const QVariantMap &result) {
+        return result.value(signalCode).toBool();
+    });
+}
 
-    if (registerCount == 1) {
-        // 单寄存器：16位数据
-        int raw = rawValues.first().toInt() & 0xFFFF;  // 转为无符号
-        if (signal.scaleFactor > 0) {
-            // scaleFactor 表示小数位数，例如 scaleFactor=3 表示除以 1000
-            double value = raw / std::pow(10, signal.scaleFactor);
-            return value;
+QFuture<QVariantMap> SignalManager::writeSignalValues(const QVariantMap &values)
+{
+    // 上一次写入（含按位改写的回读）全部完成后才开始本次，读-改-写不会与其他写入交错
+    const QFuture<QVariantMap> future =
+        m_writeTail.then(this, [this, values]() { return executeWrite(values); }).unwrap();
+    m_writeTail = future.then([](const QVariantMap &) {}).onCanceled([]() {});
+    return future;
+}
+
+QFuture<bool> SignalManager::writeRegisters(ModbusManager::RegisterType type, int address,
+                                            const QVector<quint16> &values)
+{
+    const QFuture<bool> future = m_writeTail.then(this, [this, type, address, values]() {
+        m_image.invalidate(type, address, values.size());
+        if (type == ModbusManager::Coils) {
+            return m_modbusManager->writeCoilsAsync(address, values);
         }
-        return raw;
-    }
-
-    if (registerCount == 2 && rawValues.size() >= 2) {
-        // 双寄存器：32位浮点数
-        // 与老项目保持一致：shortData[1] << 16 | shortData[0]
-        quint16 low = static_cast<quint16>(rawValues[0].toUInt());
-        quint16 high = static_cast<quint16>(rawValues[1].toUInt());
-        quint32 combined = (static_cast<quint32>(high) << 16) | low;
-        float floatVal;
-        memcpy(&floatVal, &combined, sizeof(float));
-        return static_cast<double>(floatVal);
-    }
-
-    if (registerCount == 4 && rawValues.size() >= 4) {
-        // 四寄存器：64位数据
-        if (dataType == "double") {
-            qint64 longBits = (static_cast<qint64>(rawValues[0].toInt()) << 48) |
-                             (static_cast<qint64>(rawValues[1].toUInt() & 0xFFFF) << 32) |
-                             (static_cast<qint64>(rawValues[2].toUInt() & 0xFFFF) << 16) |
-                             (rawValues[3].toUInt() & 0xFFFF);
-            double doubleVal;
-            memcpy(&doubleVal, &longBits, sizeof(double));
-            return doubleVal;
+        return m_modbusManager->writeRegistersAsync(address, values);
+    }).unwrap();
+    m_writeTail = future.then([](bool) {}).onCanceled([]() {});
+    return future;
+}
+
+QFuture<QVariantMap> SignalManager::executeWrite(const QVariantMap &values)
+{
+    auto job = std::make_shared<WriteJob>();
+    job->generation = m_generation;
+    job->values = values;
+
+    QHash<int, int> wordItems;                      // 按位写入的寄存器地址 -> 写入项
+    QVector<ReadItem> wordReads;
+
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        const QString &code = it.key();
+        const SignalHandle handle = m_table.handleOf(code);
+        if (handle == SignalTable::InvalidHandle) {
+            emit errorOccurred(QStringLiteral("信号不存在: %1").arg(code));
+            job->result.insert(code, false);
+            continue;
         }
-        // 64位长整数
-        return (static_cast<qint64>(rawValues[0].toInt()) << 48) |
-               (static_cast<qint64>(rawValues[1].toUInt() & 0xFFFF) << 32) |
-               (static_cast<qint64>(rawValues[2].toUInt() & 0xFFFF) << 16) |
-               (rawValues[3].toUInt() & 0xFFFF);
+        if (!m_table.isWritable(handle)) {
+            emit errorOccurred(QStringLiteral("信号不可写: %1").arg(code));
+            job->result.insert(code, false);
+            continue;
+        }
+        // 写入成功后置为 true
+        job->result.insert(code, false);
+
+        // 同一寄存器的多个位合并为一个写入项，读取当前值后一次改写
+        const SignalDecodeSpec spec = m_table.spec(handle);
+        if (spec.encodeKind == EncodeKind::BitInWord) {
+            int itemIndex = wordItems.value(spec.address, -1);
+            if (itemIndex < 0) {
+                itemIndex = job->items.size();
+                wordItems.insert(spec.address, itemIndex);
+
+                WriteItem item;
+                item.registerType = ModbusManager::HoldingRegisters;
+                item.address = spec.address;
+                item.index = itemIndex;
+                job->items.append(item);
+                job->itemCodes.append(QStringList());
+
+                ReadItem read;
+                read.registerType = ModbusManager::HoldingRegisters;
+                read.address = spec.address;
+                read.count = 1;
+                read.index = itemIndex;
+                wordReads.append(read);
+            }
+            job->itemCodes[itemIndex].append(code);
+            continue;
+        }
+
+        WriteItem item;
+        item.registerType = spec.registerType;
+        item.address = spec.address;
+        item.values = SignalCodec::encode(spec, it.value());
+        item.index = job->items.size();
+        job->items.append(item);
+        job->itemCodes.append(QStringList{code});
+    }
+
+    if (wordReads.isEmpty()) {
+        return issueWrites(job);
     }
 
-    // 默认返回第一个值
-    return rawValues.first();
+    // 按位写入的寄存器当前值合并读取（不跨越间隙），读回后在本线程改写目标位再发出写入
+    const QVector<ReadBlock> readPlan = BatchReadPlanner::plan(wordReads, 0);
+    const QList<QFuture<ModbusManager::ReadResult>> futures =
+        readBlocksAsync(readPlan, ModbusManager::OperatorPriority);
+    return QtFuture::whenAll(futures.begin(), futures.end())
+        .then(this, [this, job, readPlan](const QList<QFuture<ModbusManager::ReadResult>> &results) {
+            // 读取期间重新加载了配置，编码描述符已失效，放弃本次写入
+            if (job->generation != m_generation) {
+                emit errorOccurred(QStringLiteral("信号配置已重新加载，写入已取消"));
+                return QtFuture::makeReadyValueFuture(job->result);
+            }
+
+            for (int i = 0; i < readPlan.size(); ++i) {
+                const QVector<quint16> words = results[i].result().values;
+                for (const ReadItem &read : readPlan[i].members) {
+                    const QStringList &codes = job->itemCodes[read.index];
+                    if (words.size() < readPlan[i].count) {
+                        for (const QString &code : codes) {
+                            emit errorOccurred(QStringLiteral("读取寄存器当前值失败: %1").arg(code));
+                        }
+                        continue;
+                    }
+                    quint16 word = words[readPlan[i].offsetOf(read)];
+                    for (const QString &code : codes) {
+                        word = SignalCodec::encode(m_table.spec(m_table.handleOf(code)),
+                                                   job->values.value(code), word).value(0);
+                    }
+                    job->items[read.index].values = QVector<quint16>{word};
+                }
+            }
+            return issueWrites(job);
+        })
+        .unwrap();
 }
 
-QVariantList SignalManager::convertToRaw(const ModbusSignal &signal, const QVariant &value)
+QFuture<QVariantMap> SignalManager::issueWrites(const std::shared_ptr<WriteJob> &job)
 {
-    QVariantList result;
-    QString dataType = signal.dataType.toLower();
+    // 读取失败的按位写入项没有数据，不会被规划
+    job->plan = BatchWritePlanner::plan(job->items);
 
-    // 位类型
-    if (dataType == "bit") {
-        result.append(value.toBool() ? 1 : 0);
-        return result;
+    // 地址重叠的块按规划顺序分批：每个块排在所有与之重叠的前序块之后一批，同一批内的块互不重叠
+    job->waves.fill(0, job->plan.size());
+    for (int i = 0; i < job->plan.size(); ++i) {
+        const WriteBlock &block = job->plan[i];
+        for (int j = 0; j < i; ++j) {
+            const WriteBlock &earlier = job->plan[j];
+            if (earlier.registerType == block.registerType
+                && earlier.startAddress < block.startAddress + block.values.size()
+                && block.startAddress < earlier.startAddress + earlier.values.size()) {
+                job->waves[i] = qMax(job->waves[i], job->waves[j] + 1);
+            }
+        }
     }
+    return issueWave(job, 0);
+}
 
-    // 16位无符号整数
-    // 与读取逻辑保持一致：scaleFactor 表示小数位数
-    // 写入时需要乘以 10^scaleFactor 还原为原始值
-    if (dataType == "word" || dataType == "uint16") {
-        double val = value.toDouble();
-        int raw;
-        if (signal.scaleFactor > 0) {
-            raw = static_cast<int>(val * std::pow(10, signal.scaleFactor));
+QFuture<QVariantMap> SignalManager::issueWave(const std::shared_ptr<WriteJob> &job, int wave)
+{
+    // 同一批的写入一次性发出，由 ModbusManager 流水线发送
+    QVector<int> blocks;
+    QList<QFuture<bool>> futures;
+    for (int i = 0; i < job->plan.size(); ++i) {
+        if (job->waves[i] != wave) {
+            continue;
+        }
+        const WriteBlock &block = job->plan[i];
+        m_image.invalidate(block.registerType, block.startAddress, block.values.size());
+        if (block.registerType == ModbusManager::Coils) {
+            futures.append(m_modbusManager->writeCoilsAsync(block.startAddress, block.values));
         } else {
-            raw = static_cast<int>(val);
+            futures.append(m_modbusManager->writeRegistersAsync(block.startAddress, block.values));
         }
-        result.append(raw);
-        return result;
+        blocks.append(i);
     }
+    if (blocks.isEmpty()) {
+        return QtFuture::makeReadyValueFuture(job->result);
+    }
+
+    return QtFuture::whenAll(futures.begin(), futures.end())
+        .then(this, [this, job, wave, blocks](const QList<QFuture<bool>> &results) {
+            for (int i = 0; i < blocks.size(); ++i) {
+                if (!results[i].result()) {
+                    continue;
+                }
+                for (int itemIndex : job->plan[blocks[i]].members) {
+                    for (const QString &code : job->itemCodes[itemIndex]) {
+                        job->result.insert(code, true);
+                    }
+                }
+            }
+            return issueWave(job, wave + 1);
+        })
+        .unwrap();
+}
 
-    // 32位浮点数 - Little Endian word order（低位字在前）
-    // 与读取保持一致：result[0] 是低位字，result[1] 是高位字
-    if (dataType == "float") {
-        float floatVal = static_cast<float>(value.toDouble());
-        quint32 combined;
-        memcpy(&combined, &floatVal, sizeof(float));
-        result.append(static_cast<int>(combined & 0xFFFF));  // 低位字先添加
-        result.append(static_cast<int>(combined >> 16));     // 高位字后添加
-        return result;
+QFuture<QVariantMap> SignalManager::readGroupSnapshot(const QString &paramGroup)
+{
+    const QVector<SignalHandle> handles = groupHandles(paramGroup);
+    QStringList codes;
+    codes.reserve(handles.size());
+    for (SignalHandle handle : handles) {
+        codes.append(m_table.code(handle));
     }
 
-    // 默认作为整数处理
-    result.append(value.toInt());
-    return result;
+    return optimizedBatchRead(handles).then([paramGroup, codes](const QVariantMap &values) {
+        QStringList failedCodes;
+        for (const QString &code : codes) {
+            if (!values.contains(code)) {
+                failedCodes.append(code);
+            }
+        }
+
+        QVariantMap snapshot;
+        snapshot["paramGroup"] = paramGroup;
+        snapshot["values"] = values;
+        snapshot["failedCodes"] = failedCodes;
+        return snapshot;
+    });
 }
 
-QVariantMap SignalManager::optimizedBatchRead(const QList<ModbusSignal> &signalList)
+QFuture<QVariantMap> SignalManager::downloadRecipe(const QString &paramGroup, const QVariantMap &values)
 {
-    QVariantMap result;
+    // 快照、写入、回读各步骤间共享的中间状态
+    struct RecipeJob {
+        QVariantMap values;
+        QStringList targetCodes;
+        QStringList written;
+        QStringList unchanged;
+        QStringList failed;
+        QStringList mismatched;
+        qint64 verifyMs = 0;
+    };
+    auto job = std::make_shared<RecipeJob>();
+    job->values = values;
 
-    // 简单实现：逐个读取
-    // TODO: 优化为按连续地址分组批量读取
-    for (const ModbusSignal &signal : signalList) {
-        QVariant value = readSignalValue(signal.signalCode);
-        if (value.isValid()) {
-            result[signal.signalCode] = value;
+    // 目标信号必须属于该组别且可写
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        const SignalHandle handle = m_table.handleOf(it.key());
+        if (handle == SignalTable::InvalidHandle || !m_table.isActive(handle) || !m_table.isWritable(handle)
+            || m_table.signal(handle).paramGroup != paramGroup) {
+            emit errorOccurred(QStringLiteral("信号不属于参数组别 %1 或不可写: %2").arg(paramGroup, it.key()));
+            job->failed.append(it.key());
+            continue;
         }
+        job->targetCodes.append(it.key());
     }
 
-    return result;
+    // 快照：批量读取整个组别，刷新影像后按寄存器比较，只写入不同的信号
+    const qint64 snapshotMs = m_clock.elapsed();
+    return readGroupSnapshot(paramGroup)
+        .then(this, [this, job, snapshotMs](const QVariantMap &) {
+            // 信号编码在各步骤间重新解析，配置重新加载后失效的信号按不一致处理
+            QVariantMap diff;
+            for (const QString &code : job->targetCodes) {
+                if (imageMatches(m_table.handleOf(code), job->values.value(code), snapshotMs)) {
+                    job->unchanged.append(code);
+                } else {
+                    diff.insert(code, job->values.value(code));
+                }
+            }
+            return writeSignalValues(diff);
+        })
+        .unwrap()
+        .then(this, [this, job](const QVariantMap &writeResults) {
+            QStringList writtenCodes;
+            for (auto it = writeResults.constBegin(); it != writeResults.constEnd(); ++it) {
+                if (it.value().toBool()) {
+                    writtenCodes.append(it.key());
+                } else {
+                    job->failed.append(it.key());
+                }
+            }
+
+            // 回读校验：已写入的信号一次批量读取，按寄存器与目标比较
+            job->verifyMs = m_clock.elapsed();
+            job->targetCodes = writtenCodes;
+            if (writtenCodes.isEmpty()) {
+                return QtFuture::makeReadyValueFuture(QVariantMap());
+            }
+            return readSignalValues(writtenCodes);
+        })
+        .unwrap()
+        .then(this, [this, job](const QVariantMap &) {
+            for (const QString &code : job->targetCodes) {
+                if (imageMatches(m_table.handleOf(code), job->values.value(code), job->verifyMs)) {
+                    job->written.append(code);
+                } else {
+                    job->mismatched.append(code);
+                }
+            }
+
+            QVariantMap result;
+            result["success"] = job->failed.isEmpty() && job->mismatched.isEmpty();
+            result["written"] = job->written;
+            result["unchanged"] = job->unchanged;
+            result["failed"] = job->failed;
+            result["mismatched"] = job->mismatched;
+            return result;
+        });
+}
+
+QVector<SignalHandle> SignalManager::groupHandles(const QString &paramGroup) const
+{
+    QVector<SignalHandle> handles;
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        if (m_table.isActive(handle) && m_table.signal(handle).paramGroup == paramGroup) {
+            handles.append(handle);
+        }
+    }
+    return handles;
+}
+
+bool SignalManager::imageMatches(SignalHandle handle, const QVariant &value, qint64 refreshedAfterMs) const
+{
+    const int blockId = m_image.blockOf(handle);
+    if (blockId < 0 || m_image.block(blockId).refreshedMs < refreshedAfterMs) {
+        return false;
+    }
+
+    const quint16 *raw = m_image.signalData(m_table, handle);
+    const SignalDecodeSpec spec = m_table.spec(handle);
+    if (spec.encodeKind == EncodeKind::BitInWord) {
+        // 只比较目标位，其余位不属于该信号
+        return SignalCodec::encode(spec, value, raw[0]).value(0) == raw[0];
+    }
+
+    const QVector<quint16> encoded = SignalCodec::encode(spec, value);
+    if (encoded.isEmpty() || encoded.size() > spec.registerCount) {
+        return false;
+    }
+    return std::equal(encoded.constBegin(), encoded.constEnd(), raw);
+}
+
+QFuture<QVariantMap> SignalManager::optimizedBatchRead(const QVector<SignalHandle> &handles)
+{
+    const QVector<ReadBlock> plan = buildReadPlan(handles);
+    if (plan.isEmpty()) {
+        for (SignalHandle handle : handles) {
+            m_table.markCommError(handle);
+        }
+        return QtFuture::makeReadyValueFuture(QVariantMap());
+    }
+
+    // 连续发出所有块请求，由 ModbusManager 按在途窗口流水线发送，全部完成后在本线程处理
+    const quint64 generation = m_generation;
+    const quint64 planVersion = m_planVersion;
+    const QList<QFuture<ModbusManager::ReadResult>> futures = readBlocksAsync(plan);
+    return QtFuture::whenAll(futures.begin(), futures.end())
+        .then(this, [this, handles, plan, generation, planVersion](
+                        const QList<QFuture<ModbusManager::ReadResult>> &results) {
+            // 读取期间重新加载了配置或修复了读取计划，句柄或块 ID 已失效
+            if (generation != m_generation || planVersion != m_planVersion) {
+                return QVariantMap();
+            }
+
+            const qint64 nowMs = m_clock.elapsed();
+            QVector<bool> refreshed(m_image.blockCount(), false);
+            for (int i = 0; i < plan.size(); ++i) {
+                const ModbusManager::ReadResult result = results[i].result();
+                if (storeResponse(plan[i], result.values.constData(), result.values.size(), nowMs)) {
+                    for (const ReadItem &item : plan[i].members) {
+                        refreshed[item.index] = true;
+                    }
+                } else if (result.isException()) {
+                    scheduleFaultIsolation(plan[i]);
+                }
+            }
+
+            QVector<SignalHandle> decoded;
+            decoded.reserve(handles.size());
+            for (SignalHandle handle : handles) {
+                const int blockId = m_image.blockOf(handle);
+                if (blockId >= 0 && refreshed[blockId]) {
+                    decoded.append(handle);
+                } else {
+                    m_table.markCommError(handle);
+                }
+            }
+
+            QVector<QVariant> values;
+            m_decoder.decode(m_table, m_image, decoded, values);
+
+            QVariantMap result;
+            for (int i = 0; i < decoded.size(); ++i) {
+                if (values[i].isValid()) {
+                    m_table.storeValue(decoded[i], values[i], nowMs);
+                    result.insert(m_table.code(decoded[i]), values[i]);
+                }
+            }
+            return result;
+        });
+}
+
+QVector<ReadBlock> SignalManager::buildReadPlan(const QVector<SignalHandle> &handles) const
+{
+    // 读取单位为信号所在的影像块，同一块内的信号只读取一次；
+    // 不同分段的块之间存在被 PLC 拒绝的地址，按分段分别规划，避免合并后整块失败
+    QVector<bool> selected(m_image.blockCount(), false);
+    QMap<QPair<int, int>, QVector<ReadItem>> segments;
+    for (SignalHandle handle : handles) {
+        const int blockId = m_image.blockOf(handle);
+        if (blockId < 0 || selected[blockId]) {
+            continue;
+        }
+        selected[blockId] = true;
+
+        const ImageBlock &block = m_image.block(blockId);
+        ReadItem item;
+        item.registerType = block.registerType;
+        item.address = block.startAddress;
+        item.count = block.count;
+        item.index = blockId;
+        segments[qMakePair(static_cast<int>(block.registerType),
+                           m_image.segmentOf(block.registerType, block.startAddress))].append(item);
+    }
+
+    QVector<ReadBlock> plan;
+    for (auto it = segments.constBegin(); it != segments.constEnd(); ++it) {
+        plan += BatchReadPlanner::plan(it.value(), m_readGapTolerance);
+    }
+    return plan;
+}
+
+QList<QFuture<ModbusManager::ReadResult>> SignalManager::readBlocksAsync(const QVector<ReadBlock> &plan,
+                                                                          ModbusManager::RequestPriority priority)
+{
+    QList<QFuture<ModbusManager::ReadResult>> futures;
+    futures.reserve(plan.size());
+    for (const ReadBlock &block : plan) {
+        futures.append(m_modbusManager->readDetailedAsync(block.registerType, block.startAddress, block.count,
+                                                          0, priority));
+    }
+    return futures;
+}
+
+void SignalManager::scheduleFaultIsolation(const ReadBlock &request)
+{
+    // 在本轮结果处理完成后执行；期间读取计划已被修复或配置已重新加载时放弃
+    const quint64 generation = m_generation;
+    const quint64 planVersion = m_planVersion;
+    QMetaObject::invokeMethod(this, [this, request, generation, planVersion]() {
+        if (generation == m_generation && planVersion == m_planVersion) {
+            isolateFaults(request);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void SignalManager::isolateFaults(const ReadBlock &request)
+{
+    // 二分期间各轮轮询仍会遇到同一异常，正在隔离时不重复发起
+    if (m_isolatingFaults) {
+        return;
+    }
+
+    // 请求覆盖的全部信号（不限于已订阅的），按地址排序后二分
+    QVector<bool> requested(m_image.blockCount(), false);
+    for (const ReadItem &item : request.members) {
+        requested[item.index] = true;
+    }
+    auto job = std::make_shared<FaultIsolationJob>();
+    job->registerType = request.registerType;
+    job->generation = m_generation;
+    job->planVersion = m_planVersion;
+    for (SignalHandle handle = 0; handle < m_table.size(); ++handle) {
+        const int blockId = m_image.blockOf(handle);
+        if (blockId >= 0 && requested[blockId]) {
+            job->handles.append(handle);
+        }
+    }
+    std::sort(job->handles.begin(), job->handles.end(), [this](SignalHandle a, SignalHandle b) {
+        return m_table.address(a) < m_table.address(b);
+    });
+    if (job->handles.isEmpty()) {
+        return;
+    }
+
+    m_isolatingFaults = true;
+    job->pending.append(qMakePair(0, static_cast<int>(job->handles.size())));
+    bisectNext(job);
+}
+
+void SignalManager::bisectNext(const std::shared_ptr<FaultIsolationJob> &job)
+{
+    if (job->pending.isEmpty()) {
+        m_isolatingFaults = false;
+        applyFaultIsolation(*job);
+        return;
+    }
+
+    const QPair<int, int> range = job->pending.takeLast();
+    const int start = m_table.address(job->handles[range.first]);
+    int stop = start;
+    for (int i = range.first; i < range.second; ++i) {
+        stop = qMax(stop, m_table.address(job->handles[i]) + m_table.registerCount(job->handles[i]));
+    }
+
+    m_modbusManager->readDetailedAsync(job->registerType, start, stop - start, 0, ModbusManager::BackgroundPriority)
+        .then(this, [this, job, range, count = stop - start](const ModbusManager::ReadResult &result) {
+            if (job->generation != m_generation || job->planVersion != m_planVersion) {
+                m_isolatingFaults = false;
+                return;
+            }
+
+            if (result.values.size() >= count) {
+                job->segments.append(range);
+            } else if (!result.isException()) {
+                m_isolatingFaults = false;
+                return;
+            } else if (range.second - range.first == 1) {
+                job->faulty.append(job->handles[range.first]);
+            } else {
+                // 先重读低地址的一半，分段结果保持地址升序
+                const int mid = range.first + (range.second - range.first) / 2;
+                job->pending.append(qMakePair(mid, range.second));
+                job->pending.append(qMakePair(range.first, mid));
+            }
+            bisectNext(job);
+        });
+}
+
+void SignalManager::applyFaultIsolation(const FaultIsolationJob &job)
+{
+    if (job.faulty.isEmpty() && job.segments.size() <= 1) {
+        // 整体重读成功：偶发异常，不修改读取计划
+        return;
+    }
+
+    // 隔离单独读取也被拒绝的信号，相邻的正常区间之间加入分割点，修复后的计划在重新加载前一直有效
+    QStringList faultyCodes;
+    for (SignalHandle handle : job.faulty) {
+        m_quarantined[handle] = true;
+        m_table.markCommError(handle);
+        faultyCodes.append(m_table.code(handle));
+    }
+    for (int i = 1; i < job.segments.size(); ++i) {
+        m_image.addSplitPoint(job.registerType, m_table.address(job.handles[job.segments[i].first]));
+    }
+
+    m_image.build(m_table, m_readGapTolerance, m_quarantined);
+    m_planVersion++;
+    m_activePlanDirty = true;
+
+    if (!faultyCodes.isEmpty()) {
+        emit errorOccurred(QStringLiteral("信号地址被 PLC 拒绝，已停止读取: %1").arg(faultyCodes.join(", ")));
+    }
+}
+
+QStringList SignalManager::quarantinedSignals() const
+{
+    QStringList codes;
+    for (SignalHandle handle = 0; handle < m_quarantined.size(); ++handle) {
+        if (m_quarantined[handle]) {
+            codes.append(m_table.code(handle));
+        }
+    }
+    return codes;
+}
+
+bool SignalManager::storeResponse(const ReadBlock &request, const quint16 *values, int count, qint64 nowMs)
+{
+    if (count < request.count) {
+        return false;
+    }
+
+    for (const ReadItem &item : request.members) {
+        m_image.store(item.index, values + request.offsetOf(item), nowMs);
+    }
+    return true;
+}
+
+void SignalManager::collectSignals(PollClass pollClass, int blockId, bool refreshed,
+                                   qint64 nowMs, QVector<SignalHandle> &pending)
+{
+    const QVector<SignalHandle> handles = m_blockMembers[pollClass].value(blockId);
+    if (!refreshed) {
+        for (SignalHandle handle : handles) {
+            m_table.markCommError(handle);
+        }
+        return;
+    }
+
+    // 块数据自本等级上次解码后未变化时，只有上报待定的信号需要重新判断
+    quint64 &decodedRevision = m_decodedRevisions[pollClass][blockId];
+    const quint64 revision = m_image.block(blockId).revision;
+    const bool blockChanged = revision != decodedRevision;
+    decodedRevision = revision;
+
+    for (SignalHandle handle : handles) {
+        if (blockChanged || m_table.isReportPending(handle)) {
+            pending.append(handle);
+        } else {
+            m_table.markRefreshed(handle, nowMs);
+        }
+    }
 }
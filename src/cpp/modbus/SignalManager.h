@@ -4,10 +4,21 @@
 #include <QObject>
 #include <QVariantMap>
 #include <QVariantList>
-#include <QMap>
+#include <QVector>
+#include <QFuture>
 #include <QTimer>
+#include <QHash>
+#include <QElapsedTimer>
+#include <memory>
+#include "ModbusSignal.h"
+#include "SignalTable.h"
+#include "BatchReadPlanner.h"
+#include "BatchWritePlanner.h"
+#include "RegisterImage.h"
+#include "BulkDecoder.h"
+#include "ReadBatch.h"
+#include "ModbusManager.h"
 
-class ModbusManager;
 class PlcAddressMapper;
 
 /**
@@ -16,37 +27,22 @@ class PlcAddressMapper;
  * @description 负责信号配置管理、数据类型转换、批量读写优化
  */
 
-/**
- * @brief 信号配置结构体
- */
-struct ModbusSignal {
-    qint64 id;                  // 信号 ID
-    qint64 deviceId;            // 设备 ID
-    QString signalCode;         // 信号编码
-    QString signalName;         // 信号名称
-    QString signalType;         // 信号类型：read/write
-    QString registerType;       // 寄存器类型：1=线圈, 3=保持寄存器
-    int registerAddress;        // 寄存器地址
-    QString dataType;           // 数据类型：bit/word/float/double
-    int registerCount;          // 寄存器数量
-    int scaleFactor;            // 比例因子
-    int offsetValue;            // 偏移量
-    QString unit;               // 单位
-    QString plcAreaType;        // PLC 软元件区域类型
-    QString paramGroup;         // 参数组别
-    bool isActive;              // 是否启用
-
-    ModbusSignal()
-        : id(0), deviceId(0), registerAddress(0)
-        , registerCount(1), scaleFactor(1), offsetValue(0)
-        , isActive(true) {}
-};
-
 class SignalManager : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief 轮询等级
+     * @description 按参数组别划分，各等级按各自周期轮询，共用同一连接
+     */
+    enum PollClass {
+        FastPoll = 0,       // 快速：握手位、状态位
+        NormalPoll,         // 常规：过程值（未指定等级的参数组）
+        SlowPoll,           // 慢速：设定值等仅在换型时变化的参数
+        PollClassCount
+    };
+
     explicit SignalManager(ModbusManager *modbusManager,
                           PlcAddressMapper *addressMapper,
                           QObject *parent = nullptr);
@@ -66,7 +62,7 @@ public:
     /**
      * @brief 获取所有信号配置
      */
-    QList<ModbusSignal> allSignals() const { return m_signals.values(); }
+    QList<ModbusSignal> allSignals() const { return m_table.allSignals(); }
 
     /**
      * @brief 根据信号编码获取信号配置
@@ -78,32 +74,164 @@ public:
      */
     QList<ModbusSignal> getSignalsByGroup(const QString &paramGroup) const;
 
+    /**
+     * @brief 获取信号表（只读）
+     */
+    const SignalTable &signalTable() const { return m_table; }
+
     /**
      * @brief 清空所有信号配置
      */
     void clearSignals();
 
+    /**
+     * @brief 设置批量读取的地址间隙容差
+     * @param registers 允许合并的最大间隙（寄存器数），默认 8
+     */
+    void setReadGapTolerance(int registers);
+
+    /**
+     * @brief 获取批量读取的地址间隙容差
+     */
+    int readGapTolerance() const { return m_readGapTolerance; }
+
+    // ========== 订阅管理 ==========
+
+    /**
+     * @brief 添加订阅
+     * @description 轮询只覆盖被至少一个订阅引用的活跃信号；信号按引用计数管理，
+     *              多个视图订阅同一信号时只读取一次。信号配置重新加载后订阅自动重新解析。
+     * @param signalCodes 订阅的信号编码列表
+     * @param paramGroups 订阅的参数组别列表（组内全部信号）
+     * @return 订阅 ID，用于取消订阅
+     */
+    int addSubscription(const QStringList &signalCodes, const QStringList &paramGroups);
+
+    /**
+     * @brief 取消订阅
+     * @param subscriptionId addSubscription 返回的订阅 ID
+     * @return 订阅是否存在
+     */
+    bool removeSubscription(int subscriptionId);
+
+    /**
+     * @brief 当前订阅数量
+     */
+    int subscriptionCount() const { return m_subscriptions.size(); }
+
+    /**
+     * @brief 信号是否被订阅
+     */
+    bool isSubscribed(SignalHandle handle) const { return m_refCounts.value(handle) > 0; }
+
+    // ========== 轮询等级 ==========
+
+    /**
+     * @brief 设置参数组别的轮询等级
+     */
+    void setGroupPollClass(const QString &paramGroup, PollClass pollClass);
+
+    /**
+     * @brief 批量设置参数组别的轮询等级
+     * @param groupClasses {paramGroup: "fast" | "normal" | "slow"}，会替换原有设置
+     */
+    void setGroupPollClasses(const QVariantMap &groupClasses);
+
+    /**
+     * @brief 获取信号的轮询等级
+     */
+    PollClass pollClassOf(SignalHandle handle) const { return static_cast<PollClass>(m_pollClasses[handle]); }
+
+    /** @brief 轮询等级名称（fast / normal / slow） */
+    static QString pollClassName(PollClass pollClass);
+
+    /** @brief 按名称解析轮询等级，无法识别时返回 fallback */
+    static PollClass pollClassFromName(const QString &name, PollClass fallback = NormalPoll);
+
     // ========== 读取操作 ==========
 
     /**
      * @brief 读取单个信号值
+     * @description 不阻塞调用线程，结果在本对象所在线程中写入缓存后完成
      * @param signalCode 信号编码
-     * @return 信号值（已转换）
+     * @param maxAgeMs 缓存值质量良好且不超过该时长时直接返回缓存，不访问总线；0 表示总是读取 PLC
+     * @return 信号值（已转换）的 Future，读取失败时为无效值
      */
-    QVariant readSignalValue(const QString &signalCode);
+    QFuture<QVariant> readSignalValue(const QString &signalCode, int maxAgeMs = 0);
 
     /**
      * @brief 批量读取信号值
      * @param signalCodes 信号编码列表
+     * @param maxAgeMs 同 readSignalValue，只有缓存不满足的信号才访问总线
+     * @return 信号值映射 {signalCode: value} 的 Future
+     */
+    QFuture<QVariantMap> readSignalValues(const QStringList &signalCodes, int maxAgeMs = 0);
+
+    /**
+     * @brief 获取缓存值及其质量，不访问总线
+     * @param signalCodes 信号编码列表
+     * @return {signalCode: {value, quality: "good" | "stale" | "commError", ageMs}}，从未读取时 ageMs 为 -1
+     */
+    QVariantMap cachedValues(const QStringList &signalCodes) const;
+
+    /**
+     * @brief 获取缓存值质量
+     */
+    SignalQuality qualityOf(SignalHandle handle) const;
+
+    /** @brief 质量名称（good / stale / commError） */
+    static QString qualityName(SignalQuality quality);
+
+    /**
+     * @brief 设置缓存过期时间
+     * @param ms 超过该时长未成功读取的缓存值质量为 stale，默认 10000
+     */
+    void setStaleAfter(int ms) { m_staleAfterMs = qMax(1, ms); }
+
+    /**
+     * @brief 读取所有已订阅的活跃信号值
+     * @return 信号值映射 {signalCode: value} 的 Future
+     */
+    QFuture<QVariantMap> readAllActiveSignals();
+
+    /**
+     * @brief 异步轮询指定等级下所有已订阅的活跃信号
+     * @description 所有块请求一次性发出，结果在本对象所在线程中解码到信号表并做变化检测，
+     *              有变化时发射 signalValuesChanged，只携带本轮变化的信号句柄
+     * @param pollClass 轮询等级
+     * @return 本轮发生变化的信号数量的 Future；该等级没有需要读取的信号时返回已完成的空 Future
+     */
+    QFuture<int> pollActiveSignalsAsync(PollClass pollClass);
+
+    /**
+     * @brief 获取最近一次轮询得到的所有信号值
      * @return 信号值映射 {signalCode: value}
      */
-    QVariantMap readSignalValues(const QStringList &signalCodes);
+    QVariantMap currentValues() const;
 
     /**
-     * @brief 读取所有活跃信号值
+     * @brief 获取指定句柄的最新值
      * @return 信号值映射 {signalCode: value}
      */
-    QVariantMap readAllActiveSignals();
+    QVariantMap valuesOf(const QVector<SignalHandle> &handles) const;
+
+    /** @brief 已读取到值的信号句柄 */
+    QVector<SignalHandle> valuedHandles() const;
+
+    /**
+     * @brief 从寄存器影像读取原始数据，不访问总线
+     * @return 区间完全被影像覆盖且在缓存过期时间内刷新过时返回数据，否则返回空
+     */
+    QVector<quint16> readImage(ModbusManager::RegisterType type, int address, int count) const;
+
+    /**
+     * @brief 因地址被 PLC 拒绝而隔离的信号编码
+     * @description 隔离状态在信号配置重新加载后清除
+     */
+    QStringList quarantinedSignals() const;
+
+    /** @brief 配置版本号，信号表重新加载后递增，句柄仅在同一版本内有效 */
+    quint64 generation() const { return m_generation; }
 
     // ========== 写入操作 ==========
 
@@ -111,13 +239,50 @@ public:
      * @brief 写入单个信号值
      * @param signalCode 信号编码
      * @param value 要写入的值
-     * @return 是否写入成功
+     * @return 是否写入成功的 Future
      */
-    bool writeSignalValue(const QString &signalCode, const QVariant &value);
+    QFuture<bool> writeSignalValue(const QString &signalCode, const QVariant &value);
+
+    /**
+     * @brief 批量写入信号值
+     * @description 所有值先编码，地址首尾相接的写入合并为尽量少的 FC16/FC15 请求并一次性发出；
+     *              同一寄存器中按位引用的信号读取一次当前值后合并改写。
+     *              写入按调用顺序串行执行，上一次写入完成后才读取按位改写的当前值，不会与其他写入交错
+     * @param values {signalCode: value}
+     * @return 各信号是否写入成功 {signalCode: bool} 的 Future
+     */
+    QFuture<QVariantMap> writeSignalValues(const QVariantMap &values);
+
+    /**
+     * @brief 绕过信号直接写入寄存器或线圈
+     * @description 与 writeSignalValues 共用写入顺序，写入前使影像中重叠的块失效
+     * @return 是否写入成功的 Future
+     */
+    QFuture<bool> writeRegisters(ModbusManager::RegisterType type, int address, const QVector<quint16> &values);
+
+    // ========== 配方 ==========
+
+    /**
+     * @brief 批量读取参数组别内全部活跃信号，生成配方快照
+     * @description 总是访问总线，不使用缓存；读取失败的信号不出现在 values 中
+     * @return {paramGroup, values: {signalCode: value}, failedCodes: [signalCode]} 的 Future
+     */
+    QFuture<QVariantMap> readGroupSnapshot(const QString &paramGroup);
+
+    /**
+     * @brief 按差异下载配方
+     * @description 先读取参数组别快照，只写入编码后与 PLC 当前寄存器不同的信号（合并写入），
+     *              再对已写入的信号做一次批量回读校验
+     * @param paramGroup 参数组别
+     * @param values 目标配方 {signalCode: value}，只接受该组别内可写的活跃信号
+     * @return {success, written, unchanged, failed, mismatched}：written 为已写入且校验通过的信号，
+     *         unchanged 为无需写入的信号，failed 为无法写入的信号，mismatched 为回读与目标不一致的信号
+     */
+    QFuture<QVariantMap> downloadRecipe(const QString &paramGroup, const QVariantMap &values);
 
 signals:
-    /** @brief 信号值变化 */
-    void signalValuesChanged(const QVariantMap &values);
+    /** @brief 信号值变化，handles 为本轮发生变化的信号句柄 */
+    void signalValuesChanged(const QVector<SignalHandle> &handles);
 
     /** @brief 信号配置已加载 */
     void signalsLoaded(int count);
@@ -126,18 +291,155 @@ signals:
     void errorOccurred(const QString &error);
 
 private:
-    /** @brief 将原始寄存器值转换为实际值 */
-    QVariant convertFromRaw(const ModbusSignal &signal, const QVariantList &rawValues);
+    /**
+     * @brief 优化批量读取：按影像块读取并刷新影像，再从影像解码各信号
+     * @description 块请求一次性发出，全部完成后在本对象所在线程中处理；
+     *              期间重新加载了配置或修复了读取计划时结果作废，返回空映射
+     */
+    QFuture<QVariantMap> optimizedBatchRead(const QVector<SignalHandle> &handles);
 
-    /** @brief 将实际值转换为原始寄存器值 */
-    QVariantList convertToRaw(const ModbusSignal &signal, const QVariant &value);
+    /** @brief 为句柄列表所在的影像块生成批量读取计划，ReadItem::index 为块 ID */
+    QVector<ReadBlock> buildReadPlan(const QVector<SignalHandle> &handles) const;
 
-    /** @brief 优化批量读取（按连续地址分组） */
-    QVariantMap optimizedBatchRead(const QList<ModbusSignal> &signalList);
+    /** @brief 按指定优先级发起计划中所有块的异步请求，默认为按需读取 */
+    QList<QFuture<ModbusManager::ReadResult>> readBlocksAsync(
+        const QVector<ReadBlock> &plan,
+        ModbusManager::RequestPriority priority = ModbusManager::HandshakePriority);
+
+    /**
+     * @brief 批量写入的中间状态
+     * @description 按位写入的寄存器需等待当前值读回后才能编码，编码结果与写入结果在各步骤间共享
+     */
+    struct WriteJob {
+        quint64 generation = 0;             // 发起时的配置版本
+        QVariantMap values;                 // 目标值 {signalCode: value}
+        QVariantMap result;                 // 各信号是否写入成功
+        QVector<WriteItem> items;           // 写入项
+        QVector<QStringList> itemCodes;     // 写入项 -> 信号编码
+        QVector<WriteBlock> plan;           // 合并后的写入块
+        QVector<int> waves;                 // 写入块 -> 发送批次
+    };
+
+    /** @brief 校验、编码并执行一次批量写入（已轮到本次写入时调用） */
+    QFuture<QVariantMap> executeWrite(const QVariantMap &values);
+
+    /** @brief 合并写入项，地址重叠的块按顺序分批发出，全部完成后汇总各信号的写入结果 */
+    QFuture<QVariantMap> issueWrites(const std::shared_ptr<WriteJob> &job);
+
+    /** @brief 发出指定批次的写入块，完成后继续下一批 */
+    QFuture<QVariantMap> issueWave(const std::shared_ptr<WriteJob> &job, int wave);
+
+    /** @brief 请求被 PLC 以异常响应拒绝后，在本轮结果处理完成后隔离故障 */
+    void scheduleFaultIsolation(const ReadBlock &request);
+
+    /**
+     * @brief 隔离故障信号并修复读取计划
+     * @description 对请求覆盖的信号异步二分重读：单独读取仍被拒绝的信号被隔离（质量为 commError，不再读取），
+     *              正常区间之间加入影像分割点，此后按修复后的块批量读取。同一时刻只进行一次隔离
+     */
+    void isolateFaults(const ReadBlock &request);
+
+    /**
+     * @brief 故障隔离的二分状态，在各次重读之间共享
+     */
+    struct FaultIsolationJob {
+        ModbusManager::RegisterType registerType = ModbusManager::HoldingRegisters;
+        quint64 generation = 0;                 // 发起时的配置版本
+        quint64 planVersion = 0;                // 发起时的影像块版本
+        QVector<SignalHandle> handles;          // 请求覆盖的信号，按地址排序
+        QVector<QPair<int, int>> pending;       // 待重读的句柄区间（栈顶为地址最低的区间）
+        QVector<QPair<int, int>> segments;      // 可整体读取的句柄区间，按地址升序
+        QVector<SignalHandle> faulty;           // 单独读取也被拒绝的信号
+    };
+
+    /**
+     * @brief 重读栈顶区间，结果在本线程处理后继续下一区间，全部完成后修复读取计划
+     * @description 期间重新加载了配置或修复了读取计划时放弃；出现超时、断线等非异常响应的失败时
+     *              无法判断，放弃本次隔离，等下次异常再隔离
+     */
+    void bisectNext(const std::shared_ptr<FaultIsolationJob> &job);
+
+    /** @brief 按二分结果隔离故障信号、加入分割点并重建影像块 */
+    void applyFaultIsolation(const FaultIsolationJob &job);
+
+    /** @brief 用请求的响应数据刷新其覆盖的影像块，响应不完整（读取失败）时返回 false */
+    bool storeResponse(const ReadBlock &request, const quint16 *values, int count, qint64 nowMs);
+
+    /** @brief 参数组别内的活跃信号 */
+    QVector<SignalHandle> groupHandles(const QString &paramGroup) const;
+
+    /**
+     * @brief 影像中信号的原始数据是否等于目标值的编码结果
+     * @param refreshedAfterMs 所在块需在该时刻之后刷新过，否则视为不一致
+     */
+    bool imageMatches(SignalHandle handle, const QVariant &value, qint64 refreshedAfterMs) const;
+
+    /** @brief 缓存值是否可直接作为读取结果 */
+    bool isCacheFresh(SignalHandle handle, int maxAgeMs) const;
+
+    /**
+     * @brief 筛选影像块中该等级订阅的信号，需要解码与变化检测的句柄追加到 pending
+     * @description 块数据自该等级上次解码后未变化时，只有上报待定的信号需要解码，其余只刷新读取时刻
+     * @param refreshed 块本轮是否刷新成功，失败时标记通信错误
+     */
+    void collectSignals(PollClass pollClass, int blockId, bool refreshed,
+                        qint64 nowMs, QVector<SignalHandle> &pending);
+
+    /** @brief 按轮询等级重建已订阅活跃信号的读取计划（仅在配置、订阅或等级变化后执行） */
+    void ensureActivePlan();
+
+    /** @brief 按参数组别设置解析每个信号的轮询等级 */
+    void resolvePollClasses();
+
+    /**
+     * @brief 订阅记录
+     */
+    struct Subscription {
+        QStringList signalCodes;            // 订阅的信号编码
+        QStringList paramGroups;            // 订阅的参数组别
+        QVector<SignalHandle> handles;      // 解析后的句柄（去重）
+    };
+
+    /** @brief 将订阅解析为信号句柄 */
+    QVector<SignalHandle> resolveSubscription(const Subscription &subscription) const;
+
+    /** @brief 调整句柄引用计数，新被引用的信号在首次轮询时强制上报 */
+    void retainHandles(const QVector<SignalHandle> &handles);
+    void releaseHandles(const QVector<SignalHandle> &handles);
 
     ModbusManager *m_modbusManager;
     PlcAddressMapper *m_addressMapper;
-    QMap<QString, ModbusSignal> m_signals;  // signalCode -> signal
+    SignalTable m_table;                    // 信号表
+    quint64 m_generation;                   // 配置版本，重新加载后递增
+    quint64 m_planVersion;                  // 影像块版本，隔离故障信号后递增
+    QElapsedTimer m_clock;                  // 单调时钟，用于最小上报间隔与缓存时间戳
+    int m_staleAfterMs;                     // 缓存过期时间
+
+    // 批量读取计划
+    int m_readGapTolerance;                 // 地址间隙容差
+    bool m_activePlanDirty;                 // 活跃信号计划是否需要重建
+    QVector<ReadBlock> m_activePlans[PollClassCount];  // 各轮询等级的读取计划
+    QVector<QVector<SignalHandle>> m_blockMembers[PollClassCount];  // 各轮询等级：块 ID -> 已订阅的信号
+    QVector<quint64> m_decodedRevisions[PollClassCount];  // 各轮询等级：块 ID -> 上次解码的块数据版本
+    ReadBatch m_pollBatches[PollClassCount];  // 各轮询等级的块请求与结果存储（各轮复用）
+
+    // 寄存器影像
+    RegisterImage m_image;
+    QVector<bool> m_quarantined;            // 句柄 -> 是否因地址被拒绝而隔离
+    bool m_isolatingFaults;                 // 是否正在二分隔离故障信号
+    BulkDecoder m_decoder;                  // 批量解码器（复用缓冲区）
+
+    // 轮询等级
+    QHash<QString, PollClass> m_groupPollClasses;  // 参数组别 -> 轮询等级
+    QVector<quint8> m_pollClasses;          // 句柄 -> 轮询等级
+
+    // 订阅
+    QHash<int, Subscription> m_subscriptions;  // 订阅 ID -> 订阅记录
+    QVector<int> m_refCounts;               // 句柄 -> 订阅引用计数
+    int m_nextSubscriptionId;               // 下一个订阅 ID
+
+    // 写入顺序
+    QFuture<void> m_writeTail;              // 最近一次写入的完成 Future，下一次写入在其后开始
 };
 
 #endif // SIGNALMANAGER_H
@@ -0,0 +1,238 @@
+#include "SignalTable.h"
+#include <algorithm>
+
+/**
+ * @file SignalTable.cpp
+ * @brief 信号表实现
+ */
+
+void SignalTable::rebuild(QList<ModbusSignal> signalList)
+{
+    clear();
+
+    // 按编码稳定排序，保证 getSignals() 输出顺序与原先的 QMap 一致
+    std::stable_sort(signalList.begin(), signalList.end(),
+                     [](const ModbusSignal &a, const ModbusSignal &b) {
+                         return a.signalCode < b.signalCode;
+                     });
+
+    const int capacity = signalList.size();
+    m_codes.reserve(capacity);
+    m_addresses.reserve(capacity);
+    m_counts.reserve(capacity);
+    m_registerTypes.reserve(capacity);
+    m_decodeKinds.reserve(capacity);
+    m_encodeKinds.reserve(capacity);
+    m_wordOrders.reserve(capacity);
+    m_scaleDivisors.reserve(capacity);
+    m_bitIndexes.reserve(capacity);
+    m_flags.reserve(capacity);
+    m_values.reserve(capacity);
+    m_deadbands.reserve(capacity);
+    m_minReportIntervals.reserve(capacity);
+    m_reportedValues.reserve(capacity);
+    m_lastReportMs.reserve(capacity);
+    m_reportPending.reserve(capacity);
+    m_updatedMs.reserve(capacity);
+    m_qualities.reserve(capacity);
+    m_meta.reserve(capacity);
+    m_index.reserve(capacity);
+
+    for (const ModbusSignal &source : signalList) {
+        if (source.signalCode.isEmpty()) {
+            continue;
+        }
+
+        ModbusSignal signal = source;
+        signal.signalType = intern(signal.signalType);
+        signal.registerType = intern(signal.registerType);
+        signal.dataType = intern(signal.dataType);
+        signal.unit = intern(signal.unit);
+        signal.plcAreaType = intern(signal.plcAreaType);
+        signal.paramGroup = intern(signal.paramGroup);
+
+        const SignalDecodeSpec spec = SignalCodec::compile(signal);
+        quint8 flags = 0;
+        if (spec.active) {
+            flags |= FlagActive;
+        }
+        if (spec.writable) {
+            flags |= FlagWritable;
+        }
+        if (spec.scaled) {
+            flags |= FlagScaled;
+        }
+        if (signal.deadbandPercent) {
+            flags |= FlagDeadbandPercent;
+        }
+        const double deadband = qMax(0.0, signal.deadband);
+        const int minReportInterval = qMax(0, signal.minReportInterval);
+
+        // 编码重复时覆盖原句柄（与 QMap 语义一致：后者覆盖前者）
+        SignalHandle handle = m_index.value(signal.signalCode, InvalidHandle);
+        if (handle != InvalidHandle) {
+            m_addresses[handle] = spec.address;
+            m_counts[handle] = spec.registerCount;
+            m_registerTypes[handle] = static_cast<quint8>(spec.registerType);
+            m_decodeKinds[handle] = spec.decodeKind;
+            m_encodeKinds[handle] = spec.encodeKind;
+            m_wordOrders[handle] = spec.wordOrder;
+            m_scaleDivisors[handle] = spec.scaleDivisor;
+            m_bitIndexes[handle] = spec.bitIndex;
+            m_flags[handle] = flags;
+            m_deadbands[handle] = deadband;
+            m_minReportIntervals[handle] = minReportInterval;
+            m_meta[handle] = signal;
+            continue;
+        }
+
+        handle = m_codes.size();
+        m_index.insert(signal.signalCode, handle);
+        m_codes.append(signal.signalCode);
+        m_addresses.append(spec.address);
+        m_counts.append(spec.registerCount);
+        m_registerTypes.append(static_cast<quint8>(spec.registerType));
+        m_decodeKinds.append(spec.decodeKind);
+        m_encodeKinds.append(spec.encodeKind);
+        m_wordOrders.append(spec.wordOrder);
+        m_scaleDivisors.append(spec.scaleDivisor);
+        m_bitIndexes.append(spec.bitIndex);
+        m_flags.append(flags);
+        m_values.append(QVariant());
+        m_deadbands.append(deadband);
+        m_minReportIntervals.append(minReportInterval);
+        m_reportedValues.append(QVariant());
+        m_lastReportMs.append(0);
+        m_reportPending.append(true);
+        m_updatedMs.append(-1);
+        m_qualities.append(SignalQuality::Stale);
+        m_meta.append(signal);
+    }
+
+    // 驻留池只在构建期间使用
+    m_stringPool.clear();
+}
+
+void SignalTable::clear()
+{
+    m_index.clear();
+    m_codes.clear();
+    m_addresses.clear();
+    m_counts.clear();
+    m_registerTypes.clear();
+    m_decodeKinds.clear();
+    m_encodeKinds.clear();
+    m_wordOrders.clear();
+    m_scaleDivisors.clear();
+    m_bitIndexes.clear();
+    m_flags.clear();
+    m_values.clear();
+    m_deadbands.clear();
+    m_minReportIntervals.clear();
+    m_reportedValues.clear();
+    m_lastReportMs.clear();
+    m_reportPending.clear();
+    m_updatedMs.clear();
+    m_qualities.clear();
+    m_meta.clear();
+    m_stringPool.clear();
+}
+
+SignalDecodeSpec SignalTable::spec(SignalHandle handle) const
+{
+    SignalDecodeSpec spec;
+    spec.registerType = registerType(handle);
+    spec.address = m_addresses[handle];
+    spec.registerCount = m_counts[handle];
+    spec.decodeKind = m_decodeKinds[handle];
+    spec.encodeKind = m_encodeKinds[handle];
+    spec.wordOrder = m_wordOrders[handle];
+    spec.scaled = m_flags[handle] & FlagScaled;
+    spec.writable = m_flags[handle] & FlagWritable;
+    spec.active = m_flags[handle] & FlagActive;
+    spec.scaleDivisor = m_scaleDivisors[handle];
+    spec.bitIndex = m_bitIndexes[handle];
+    return spec;
+}
+
+QVariant SignalTable::decode(SignalHandle handle, const quint16 *raw, int count) const
+{
+    return SignalCodec::decode(spec(handle), raw, count);
+}
+
+bool SignalTable::updateValue(SignalHandle handle, const QVariant &value, qint64 nowMs)
+{
+    storeValue(handle, value, nowMs);
+
+    QVariant &reported = m_reportedValues[handle];
+    if (reported.isValid()) {
+        const double deadband = m_deadbands[handle];
+        const DecodeKind kind = m_decodeKinds[handle];
+        if (deadband > 0.0 && kind != DecodeKind::Bit && kind != DecodeKind::BitInWord) {
+            // 与上次上报值比较，缓慢漂移累积超过死区后同样会上报
+            const double last = reported.toDouble();
+            const double threshold = (m_flags[handle] & FlagDeadbandPercent)
+                ? qAbs(last) * deadband / 100.0 : deadband;
+            if (qAbs(value.toDouble() - last) <= threshold) {
+                m_reportPending[handle] = false;
+                return false;
+            }
+        } else if (reported == value) {
+            m_reportPending[handle] = false;
+            return false;
+        }
+
+        const int minInterval = m_minReportIntervals[handle];
+        if (minInterval > 0 && nowMs - m_lastReportMs[handle] < minInterval) {
+            m_reportPending[handle] = true;
+            return false;
+        }
+    }
+
+    reported = value;
+    m_lastReportMs[handle] = nowMs;
+    m_reportPending[handle] = false;
+    return true;
+}
+
+void SignalTable::storeValue(SignalHandle handle, const QVariant &value, qint64 nowMs)
+{
+    m_values[handle] = value;
+    m_updatedMs[handle] = nowMs;
+    m_qualities[handle] = SignalQuality::Good;
+}
+
+SignalQuality SignalTable::quality(SignalHandle handle, qint64 nowMs, qint64 staleAfterMs) const
+{
+    if (m_updatedMs[handle] < 0) {
+        return SignalQuality::Stale;
+    }
+    if (m_qualities[handle] == SignalQuality::Good && nowMs - m_updatedMs[handle] > staleAfterMs) {
+        return SignalQuality::Stale;
+    }
+    return m_qualities[handle];
+}
+
+void SignalTable::resetValues()
+{
+    for (int handle = 0; handle < m_values.size(); ++handle) {
+        m_values[handle] = QVariant();
+        m_reportedValues[handle] = QVariant();
+        m_reportPending[handle] = true;
+        m_updatedMs[handle] = -1;
+        m_qualities[handle] = SignalQuality::Stale;
+    }
+}
+
+QString SignalTable::intern(const QString &text)
+{
+    if (text.isEmpty()) {
+        return QString();
+    }
+    auto it = m_stringPool.constFind(text);
+    if (it != m_stringPool.constEnd()) {
+        return *it;
+    }
+    m_stringPool.insert(text);
+    return text;
+}
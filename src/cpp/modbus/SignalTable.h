@@ -0,0 +1,184 @@
+#ifndef SIGNALTABLE_H
+#define SIGNALTABLE_H
+
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QVariant>
+#include "ModbusSignal.h"
+#include "SignalCodec.h"
+
+/**
+ * @file SignalTable.h
+ * @brief 信号表
+ * @description 以结构数组（SoA）方式存储信号：地址、数量、解码类型等热数据各占一段连续数组，
+ *              每个信号分配稳定的整数句柄，仅保留一个 signalCode -> 句柄 的哈希索引。
+ *              轮询、解码和变化检测按句柄线性遍历数组，信号配置原文作为冷数据单独存放。
+ */
+
+/** 信号句柄：信号在信号表中的下标，配置重新加载前保持不变 */
+using SignalHandle = int;
+
+/**
+ * @brief 缓存值质量
+ */
+enum class SignalQuality : quint8 {
+    Good,       // 最近一次读取成功且未过期
+    Stale,      // 从未读取，或距最近一次成功读取已超过过期时间
+    CommError   // 最近一次读取失败，缓存为失败前的值
+};
+
+class SignalTable
+{
+public:
+    /** 无效句柄 */
+    static constexpr SignalHandle InvalidHandle = -1;
+
+    /**
+     * @brief 按信号列表重建信号表
+     * @description 按 signalCode 排序，编码重复时后者覆盖前者；空编码的信号被忽略
+     */
+    void rebuild(QList<ModbusSignal> signalList);
+
+    /** @brief 清空信号表 */
+    void clear();
+
+    /** @brief 信号数量 */
+    int size() const { return m_codes.size(); }
+
+    /** @brief 根据信号编码查找句柄，不存在返回 InvalidHandle */
+    SignalHandle handleOf(const QString &signalCode) const { return m_index.value(signalCode, InvalidHandle); }
+
+    /** @brief 句柄是否有效 */
+    bool isValid(SignalHandle handle) const { return handle >= 0 && handle < m_codes.size(); }
+
+    // ========== 热数据（按句柄访问） ==========
+
+    const QString &code(SignalHandle handle) const { return m_codes[handle]; }
+    ModbusManager::RegisterType registerType(SignalHandle handle) const
+    {
+        return static_cast<ModbusManager::RegisterType>(m_registerTypes[handle]);
+    }
+    int address(SignalHandle handle) const { return m_addresses[handle]; }
+    int registerCount(SignalHandle handle) const { return m_counts[handle]; }
+    bool isActive(SignalHandle handle) const { return m_flags[handle] & FlagActive; }
+    bool isWritable(SignalHandle handle) const { return m_flags[handle] & FlagWritable; }
+    DecodeKind decodeKind(SignalHandle handle) const { return m_decodeKinds[handle]; }
+    double scaleDivisor(SignalHandle handle) const { return m_scaleDivisors[handle]; }
+    int bitIndex(SignalHandle handle) const { return m_bitIndexes[handle]; }
+
+    /** @brief 组装解码描述符（栈上构造，无堆分配） */
+    SignalDecodeSpec spec(SignalHandle handle) const;
+
+    /** @brief 从原始寄存器数据解码指定信号 */
+    QVariant decode(SignalHandle handle, const quint16 *raw, int count) const;
+
+    // ========== 最新值与变化检测 ==========
+
+    /** @brief 获取最近一次轮询的值，未读取过时为无效 QVariant */
+    const QVariant &value(SignalHandle handle) const { return m_values[handle]; }
+
+    /**
+     * @brief 更新最新值并做变化过滤
+     * @description 最新值总是更新；是否上报按以下规则判断：
+     *              - 首次读取总是上报
+     *              - 数值信号配置了死区时，与上次上报值之差超过死区才上报
+     *                （百分比死区相对上次上报值的绝对值），否则按值是否相等判断
+     *              - 配置了最小上报间隔时，距上次上报不足间隔的变化暂不上报，
+     *                之后的轮询仍与上次上报值比较，变化不会丢失
+     * @param nowMs 单调时钟当前时刻（毫秒）
+     * @return 是否需要上报
+     */
+    bool updateValue(SignalHandle handle, const QVariant &value, qint64 nowMs);
+
+    /**
+     * @brief 写入缓存值（不参与上报判断），用于按需读取的结果
+     */
+    void storeValue(SignalHandle handle, const QVariant &value, qint64 nowMs);
+
+    /**
+     * @brief 原始数据未变化时刷新读取时刻与质量，不解码、不参与上报判断
+     */
+    void markRefreshed(SignalHandle handle, qint64 nowMs)
+    {
+        m_updatedMs[handle] = nowMs;
+        m_qualities[handle] = SignalQuality::Good;
+    }
+
+    /**
+     * @brief 是否有待定的上报
+     * @description 从未上报、被强制上报或变化被最小上报间隔暂缓时为 true，
+     *              此时即使原始数据未变化也需要重新经过 updateValue
+     */
+    bool isReportPending(SignalHandle handle) const { return m_reportPending[handle]; }
+
+    /** @brief 标记读取失败，保留失败前的缓存值 */
+    void markCommError(SignalHandle handle) { m_qualities[handle] = SignalQuality::CommError; }
+
+    /** @brief 最近一次成功读取的时刻（单调时钟毫秒），从未读取时为 -1 */
+    qint64 updatedAt(SignalHandle handle) const { return m_updatedMs[handle]; }
+
+    /**
+     * @brief 缓存值质量
+     * @param nowMs 单调时钟当前时刻（毫秒）
+     * @param staleAfterMs 超过该时长未成功读取视为过期
+     */
+    SignalQuality quality(SignalHandle handle, qint64 nowMs, qint64 staleAfterMs) const;
+
+    /** @brief 清除所有最新值与上报状态 */
+    void resetValues();
+
+    /** @brief 清除指定信号的上报状态，下次轮询无论是否变化都会上报，缓存值保留 */
+    void forceReport(SignalHandle handle)
+    {
+        m_reportedValues[handle] = QVariant();
+        m_reportPending[handle] = true;
+    }
+
+    // ========== 冷数据 ==========
+
+    /** @brief 获取信号配置原文 */
+    const ModbusSignal &signal(SignalHandle handle) const { return m_meta[handle]; }
+
+    /** @brief 所有信号配置（按 signalCode 排序） */
+    const QVector<ModbusSignal> &allSignals() const { return m_meta; }
+
+private:
+    enum Flag : quint8 {
+        FlagActive = 0x01,
+        FlagWritable = 0x02,
+        FlagScaled = 0x04,
+        FlagDeadbandPercent = 0x08
+    };
+
+    /** @brief 驻留重复字符串（类型、单位、组别等），使相同取值共享同一份数据 */
+    QString intern(const QString &text);
+
+    QHash<QString, SignalHandle> m_index;   // signalCode -> 句柄
+
+    // 热数据，下标即句柄
+    QVector<QString> m_codes;               // 信号编码
+    QVector<int> m_addresses;               // 已解析的 Modbus 地址
+    QVector<quint8> m_counts;               // 寄存器数量
+    QVector<quint8> m_registerTypes;        // 寄存器类型
+    QVector<DecodeKind> m_decodeKinds;      // 解码类型
+    QVector<EncodeKind> m_encodeKinds;      // 编码类型
+    QVector<WordOrder> m_wordOrders;        // 字序
+    QVector<double> m_scaleDivisors;        // 10^scaleFactor
+    QVector<quint8> m_bitIndexes;           // 寄存器内的位序号（BitInWord）
+    QVector<quint8> m_flags;                // Flag 组合
+    QVector<QVariant> m_values;             // 最新值
+    QVector<double> m_deadbands;            // 死区，0 表示不启用
+    QVector<int> m_minReportIntervals;      // 最小上报间隔（毫秒）
+    QVector<QVariant> m_reportedValues;     // 上次上报的值
+    QVector<qint64> m_lastReportMs;         // 上次上报时刻
+    QVector<bool> m_reportPending;          // 是否有待定的上报
+    QVector<qint64> m_updatedMs;            // 最近一次成功读取的时刻
+    QVector<SignalQuality> m_qualities;     // 最近一次读取结果
+
+    // 冷数据
+    QVector<ModbusSignal> m_meta;           // 信号配置原文
+    QSet<QString> m_stringPool;             // 字符串驻留池
+};
+
+#endif // SIGNALTABLE_H
@@ -6,7 +6,17 @@
 
 import { logger } from '@/utils/logger'
 import { initWebChannel, isQtEnvironment } from './channel'
-import type { ModbusSignal, SignalValuesMap } from '@/types/plc'
+import type {
+  CachedSignalValue,
+  ModbusSignal,
+  PollClass,
+  PollStats,
+  RecipeDownloadResult,
+  RecipeSnapshot,
+  SignalSchema,
+  SignalValuesMap,
+  SignalValuesSnapshot
+} from '@/types/plc'
 import type { LogFile } from '@/types/log'
 
 // Qt WebChannel 桥接类型定义
@@ -14,8 +24,6 @@ export interface PlcBridge {
   // ========== 原有接口 ==========
   readData(address: number, count: number): Promise<number[]>
   writeData(address: number, values: number[]): Promise<boolean>
-  subscribe(addresses: number[], callback: (data: Record<number, number>) => void): void
-  unsubscribe(): void
   isConnected: boolean
   connectionChanged: { connect: (callback: (connected: boolean) => void) => void }
 
@@ -24,21 +32,57 @@ export interface PlcBridge {
   getSignals(): Promise<Partial<ModbusSignal>[]>
   /** 刷新信号配置 */
   refreshSignals(): void
-  /** 根据信号编码读取值 */
-  readBySignalCode(signalCode: string): Promise<number | boolean | string>
+  /** 根据信号编码读取值（maxAgeMs 内的轮询缓存直接返回，不访问总线） */
+  readBySignalCode(signalCode: string, maxAgeMs?: number): Promise<number | boolean | string>
   /** 根据信号编码写入值 */
   writeBySignalCode(signalCode: string, value: number | boolean | string): Promise<boolean>
-  /** 批量读取信号值 */
-  batchRead(signalCodes: string[]): Promise<SignalValuesMap>
+  /** 批量写入信号值（相邻寄存器合并为尽量少的写入请求），返回各信号是否写入成功 */
+  writeSignalValues(values: Record<string, number | boolean | string>): Promise<Record<string, boolean>>
+  /** 批量读取参数组别的配方快照（总是访问总线） */
+  readGroupSnapshot(paramGroup: string): Promise<RecipeSnapshot>
+  /** 按差异下载配方：只写入与 PLC 当前值不同的信号，并批量回读校验 */
+  downloadRecipe(paramGroup: string, values: SignalValuesMap): Promise<RecipeDownloadResult>
+  /** 批量读取信号值（maxAgeMs 同 readBySignalCode） */
+  batchRead(signalCodes: string[], maxAgeMs?: number): Promise<SignalValuesMap>
+  /** 读取缓存的信号值及质量，不访问总线 */
+  readCachedSignals(signalCodes: string[]): Promise<Record<string, CachedSignalValue>>
+  /** 获取当前全部信号值快照（版本号不连续时重新同步） */
+  getSignalValues(): Promise<SignalValuesSnapshot>
+
+  // ========== 紧凑推送 ==========
+  /** 切换紧凑推送格式（开启后值通过 signalValuesPacked 推送，int64 信号仍通过 signalValuesChanged） */
+  setCompactPush(enabled: boolean): void
+  /** 获取紧凑推送的信号索引表 */
+  getSignalSchema(): Promise<SignalSchema>
+
+  // ========== 推送限速 ==========
+  /** 设置界面刷新频率上限（次/秒，1~60），两帧之间的变化合并推送 */
+  setUiRefreshRate(hz: number): void
+  /** 设置紧急信号，变化时立即推送 */
+  setUrgentSignals(signalCodes: string[]): void
 
   // ========== 轮询控制 ==========
   /** 启动数据轮询 */
   startPolling(intervalMs?: number): void
   /** 停止数据轮询 */
   stopPolling(): void
+  /** 设置轮询等级的周期（normal 等级由 startPolling 指定） */
+  setPollClassInterval(pollClass: PollClass, intervalMs: number): void
+  /** 设置参数组别的轮询等级 */
+  setGroupPollClass(paramGroup: string, pollClass: PollClass): void
+  /** 获取轮询周期统计（按轮询等级统计耗时、抖动、超限与跳过次数） */
+  getPollStats(): Promise<PollStats>
+  /** 获取因地址被 PLC 拒绝而停止读取的信号编码（重新加载信号配置后清除） */
+  getQuarantinedSignals(): Promise<string[]>
   /** 轮询状态 */
   isPolling: boolean
 
+  // ========== 订阅接口 ==========
+  /** 订阅信号（按信号编码或参数组别），轮询只读取被订阅的信号，返回订阅 ID */
+  subscribe(signalCodes: string[], paramGroups: string[]): Promise<number>
+  /** 取消订阅 */
+  unsubscribe(subscriptionId: number): void
+
   // ========== 初始化接口 ==========
   /** 前端登录成功后调用，传递 Token 并初始化设备配置 */
   initWithToken(token: string): void
@@ -50,7 +94,17 @@ export interface PlcBridge {
   readLogFile(filePath: string): Promise<string>
 
   // ========== 信号 ==========
-  signalValuesChanged: { connect: (callback: (values: SignalValuesMap) => void) => void }
+  /** 信号值推送：增量推送只含变化的信号，fullSync 为 true 时为全量同步 */
+  signalValuesChanged: {
+    connect: (callback: (values: SignalValuesMap, version: number, fullSync: boolean) => void) => void
+  }
+  /** 紧凑格式推送：packed 为 base64（n 个 Float64 值 + n 个 Uint32 索引，小端） */
+  signalValuesPacked: {
+    connect: (
+      callback: (packed: string, schemaVersion: number, version: number, fullSync: boolean) => void
+    ) => void
+  }
+  signalSchemaChanged: { connect: (callback: (schema: SignalSchema) => void) => void }
   signalsConfigChanged: { connect: (callback: (count: number) => void) => void }
   pollingChanged: { connect: (callback: (polling: boolean) => void) => void }
 }
@@ -97,6 +151,7 @@ export function getPlcBridge(): PlcBridge | null {
 // 模拟桥接（开发环境）
 function createMockBridge(): PlcBridge {
   let polling = false
+  let nextSubscriptionId = 1
   const mockSignals: Partial<ModbusSignal>[] = [
     { id: 1, signalCode: 'PRESSURE', signalName: '压力', dataType: 'float', unit: 'MPa', isActive: true },
     { id: 2, signalCode: 'TEMPERATURE', signalName: '温度', dataType: 'float', unit: '°C', isActive: true },
@@ -111,19 +166,47 @@ function createMockBridge(): PlcBridge {
       }
     },
     signalValuesChanged: { connect: () => {} },
+    signalValuesPacked: { connect: () => {} },
+    signalSchemaChanged: { connect: () => {} },
     signalsConfigChanged: { connect: () => {} },
     pollingChanged: { connect: () => {} },
     readData: async () => [],
     writeData: async () => true,
-    subscribe: () => {},
+    subscribe: async () => nextSubscriptionId++,
     unsubscribe: () => {},
     getSignals: async () => mockSignals,
     refreshSignals: () => {},
     readBySignalCode: async () => 0,
     writeBySignalCode: async () => true,
+    writeSignalValues: async (values) =>
+      Object.fromEntries(Object.keys(values).map(code => [code, true])),
+    readGroupSnapshot: async (paramGroup) => ({ paramGroup, values: {}, failedCodes: [] }),
+    downloadRecipe: async (_paramGroup, values) => ({
+      success: true,
+      written: Object.keys(values),
+      unchanged: [],
+      failed: [],
+      mismatched: []
+    }),
     batchRead: async () => ({}),
+    readCachedSignals: async () => ({}),
+    getSignalValues: async () => ({ version: 0, values: {} }),
+    setCompactPush: () => {},
+    getSignalSchema: async () => ({ schemaVersion: 0, codes: [], types: [] }),
+    setUiRefreshRate: () => {},
+    setUrgentSignals: () => {},
     startPolling: () => { polling = true },
     stopPolling: () => { polling = false },
+    setPollClassInterval: () => {},
+    setGroupPollClass: () => {},
+    getPollStats: async () => ({
+      running: polling,
+      cycleCount: 0,
+      overrunCount: 0,
+      skippedCycles: 0,
+      groups: {},
+    }),
+    getQuarantinedSignals: async () => [],
     initWithToken: () => { logger.info('Mock: initWithToken called') },
     getLogFiles: async () => {
       // 模拟日志文件列表
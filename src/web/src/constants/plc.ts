@@ -16,6 +16,14 @@ export const PLC_THROTTLE = {
   STATUS_CHECK: 500,        // 状态检查节流间隔（毫秒）
 } as const
 
+/** 信号值推送配置 */
+export const PLC_PUSH = {
+  /** 是否使用紧凑推送格式（按索引打包的二进制数据） */
+  COMPACT: true,
+  /** 界面刷新频率上限（次/秒），与 PLC 轮询频率无关 */
+  UI_REFRESH_HZ: 25,
+} as const
+
 /** 设备参数展示配置 */
 export const DEVICE_PARAMS = {
   /** 参数轮询间隔（毫秒） */
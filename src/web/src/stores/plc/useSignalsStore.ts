@@ -7,9 +7,16 @@
 import { defineStore } from 'pinia'
 import { ref, computed } from 'vue'
 import { getPlcBridge } from '@/bridge/plc'
-import type { ModbusSignal, SignalValuesMap } from '@/types/plc'
+import type {
+  ModbusSignal,
+  RecipeDownloadResult,
+  RecipeSnapshot,
+  SignalSchema,
+  SignalValuesMap
+} from '@/types/plc'
 import { logger } from '@/utils/logger'
-import { MES_COMMUNICATION } from '@/constants/plc'
+import { decodePackedValues } from '@/utils/packedValues'
+import { MES_COMMUNICATION, PLC_PUSH } from '@/constants/plc'
 
 export const useSignalsStore = defineStore('signals', () => {
   // ========== 状态 ==========
@@ -21,6 +28,14 @@ export const useSignalsStore = defineStore('signals', () => {
   const loading = ref(false)
   /** 轮询状态 */
   const polling = ref(false)
+  /** 最近一次应用的推送版本号 */
+  let valueVersion = 0
+  /** 是否正在重新同步 */
+  let resyncing = false
+  /** 紧凑推送的信号索引表 */
+  let schema: SignalSchema | null = null
+  /** 进行中的索引表请求 */
+  let schemaRequest: Promise<void> | null = null
 
   // ========== 计算属性 ==========
   /** 按参数组别分组的信号 */
@@ -114,9 +129,119 @@ export const useSignalsStore = defineStore('signals', () => {
     return values.value[signalCode]
   }
 
-  /** 更新信号值 */
+  /**
+   * 更新信号值
+   * @description 逐项就地更新，只有依赖变化信号的组件会重新渲染
+   */
   function updateValues(newValues: SignalValuesMap) {
-    values.value = { ...values.value, ...newValues }
+    for (const code in newValues) {
+      values.value[code] = newValues[code]
+    }
+  }
+
+  /**
+   * 应用信号值推送
+   * @param newValues - 增量推送为变化的信号，全量同步为全部信号
+   * @param version - 推送版本号
+   * @param fullSync - 是否为全量同步
+   */
+  function applyValuePush(newValues: SignalValuesMap, version: number, fullSync: boolean) {
+    // 重复或过期的推送（监听被重复注册、快照已更新）直接忽略
+    if (version <= valueVersion) return
+
+    if (fullSync) {
+      values.value = { ...newValues }
+      valueVersion = version
+      return
+    }
+
+    updateValues(newValues)
+
+    // 版本号不连续说明丢失了增量，主动拉取全量快照
+    const expected = valueVersion + 1
+    valueVersion = version
+    if (version !== expected) {
+      resyncValues()
+    }
+  }
+
+  /** 拉取全量信号值快照重新同步 */
+  async function resyncValues() {
+    const bridge = getPlcBridge()
+    if (!bridge || resyncing) return
+
+    resyncing = true
+    try {
+      const snapshot = await bridge.getSignalValues()
+      // 等待期间已有更新的推送时，快照已过期，交给后续推送或全量同步
+      if (snapshot.version >= valueVersion) {
+        values.value = { ...snapshot.values }
+        valueVersion = snapshot.version
+      }
+    } catch (error) {
+      logger.error('信号值重新同步失败', error)
+    } finally {
+      resyncing = false
+    }
+  }
+
+  /**
+   * 应用紧凑格式推送
+   * @description 索引表版本不一致时丢弃本次推送，重新获取索引表并全量同步
+   */
+  function applyPackedPush(
+    packed: string,
+    schemaVersion: number,
+    version: number,
+    fullSync: boolean
+  ) {
+    if (!schema || schema.schemaVersion !== schemaVersion) {
+      loadSchema().then(resyncValues)
+      return
+    }
+
+    const newValues = decodePackedValues(packed, schema)
+    if (!newValues) {
+      logger.warn('紧凑推送数据无法解码，重新同步')
+      resyncValues()
+      return
+    }
+    applyValuePush(newValues, version, fullSync)
+  }
+
+  /** 获取紧凑推送的信号索引表（并发调用共享同一次请求） */
+  function loadSchema(): Promise<void> {
+    const bridge = getPlcBridge()
+    if (!bridge) return Promise.resolve()
+
+    if (!schemaRequest) {
+      schemaRequest = bridge.getSignalSchema()
+        .then((result) => {
+          schema = result
+        })
+        .catch((error: unknown) => {
+          logger.error('获取信号索引表失败', error)
+        })
+        .finally(() => {
+          schemaRequest = null
+        })
+    }
+    return schemaRequest
+  }
+
+  /**
+   * 启用紧凑推送
+   * @description 先获取索引表再通知后端切换格式，避免收到无法解码的推送
+   */
+  async function enableCompactPush() {
+    const bridge = getPlcBridge()
+    if (!bridge) return
+
+    await loadSchema()
+    if (schema) {
+      bridge.setCompactPush(true)
+      logger.info('已启用紧凑推送', { signalCount: schema.codes.length })
+    }
   }
 
   /** 启动轮询 */
@@ -137,6 +262,45 @@ export const useSignalsStore = defineStore('signals', () => {
     }
   }
 
+  /**
+   * 订阅信号
+   * @description 轮询只读取被至少一个视图订阅的信号，视图卸载时需调用 unsubscribe
+   * @param signalCodes - 信号编码列表
+   * @param paramGroups - 参数组别列表（组内全部信号）
+   * @returns 订阅 ID，失败返回 null
+   */
+  async function subscribe(
+    signalCodes: string[],
+    paramGroups: string[] = []
+  ): Promise<number | null> {
+    const bridge = getPlcBridge()
+    if (!bridge) {
+      logger.warn('PlcBridge 未初始化，无法订阅信号')
+      return null
+    }
+
+    try {
+      const subscriptionId = await bridge.subscribe(signalCodes, paramGroups)
+      logger.debug('已订阅信号', { subscriptionId, signalCodes, paramGroups })
+      return subscriptionId
+    } catch (error) {
+      logger.error('订阅信号失败', error)
+      return null
+    }
+  }
+
+  /**
+   * 取消订阅
+   * @param subscriptionId - subscribe 返回的订阅 ID
+   */
+  function unsubscribe(subscriptionId: number) {
+    const bridge = getPlcBridge()
+    if (bridge) {
+      bridge.unsubscribe(subscriptionId)
+      logger.debug('已取消订阅', { subscriptionId })
+    }
+  }
+
   /** 初始化信号监听 */
   function initListeners() {
     const bridge = getPlcBridge()
@@ -144,11 +308,31 @@ export const useSignalsStore = defineStore('signals', () => {
 
     // 信号值变化监听（添加安全检查）
     if (bridge.signalValuesChanged && typeof bridge.signalValuesChanged.connect === 'function') {
-      bridge.signalValuesChanged.connect((newValues) => {
-        updateValues(newValues)
+      bridge.signalValuesChanged.connect((newValues, version, fullSync) => {
+        applyValuePush(newValues, version, fullSync)
       })
     }
 
+    // 界面刷新频率上限
+    if (typeof bridge.setUiRefreshRate === 'function') {
+      bridge.setUiRefreshRate(PLC_PUSH.UI_REFRESH_HZ)
+    }
+
+    // 紧凑格式推送监听（后端支持时启用）
+    if (
+      PLC_PUSH.COMPACT &&
+      bridge.signalValuesPacked &&
+      typeof bridge.signalValuesPacked.connect === 'function'
+    ) {
+      bridge.signalValuesPacked.connect((packed, schemaVersion, version, fullSync) => {
+        applyPackedPush(packed, schemaVersion, version, fullSync)
+      })
+      bridge.signalSchemaChanged.connect((newSchema) => {
+        schema = newSchema
+      })
+      enableCompactPush()
+    }
+
     // 信号配置变化监听（添加安全检查）
     if (bridge.signalsConfigChanged && typeof bridge.signalsConfigChanged.connect === 'function') {
       bridge.signalsConfigChanged.connect(() => {
@@ -253,10 +437,12 @@ export const useSignalsStore = defineStore('signals', () => {
   /**
    * 读取单个信号值
    * @param signalCode - 信号编码
+   * @param maxAgeMs - 轮询缓存不超过该时长时直接返回缓存，不访问总线；默认总是读取 PLC
    * @returns 信号值，失败返回 null
    */
   async function readSingleSignal(
-    signalCode: string
+    signalCode: string,
+    maxAgeMs = 0
   ): Promise<number | boolean | string | null> {
     const bridge = getPlcBridge()
     if (!bridge) {
@@ -265,7 +451,7 @@ export const useSignalsStore = defineStore('signals', () => {
     }
 
     try {
-      const value = await bridge.readBySignalCode(signalCode)
+      const value = await bridge.readBySignalCode(signalCode, maxAgeMs)
       logger.info(`读取信号 ${signalCode} 成功`, { value })
       return value
     } catch (error) {
@@ -304,6 +490,112 @@ export const useSignalsStore = defineStore('signals', () => {
     }
   }
 
+  /**
+   * 批量写入信号值
+   * @description 相邻寄存器合并为尽量少的写入请求，用于换型时下发整组参数
+   * @param values - {信号编码: 值}
+   * @returns 各信号是否写入成功，桥接不可用或调用失败时全部为 false
+   */
+  async function writeSignals(
+    values: Record<string, number | boolean | string>
+  ): Promise<Record<string, boolean>> {
+    const failed = () => Object.fromEntries(Object.keys(values).map(code => [code, false]))
+    const bridge = getPlcBridge()
+    if (!bridge) {
+      logger.warn('PlcBridge 未初始化，无法写入信号')
+      return failed()
+    }
+
+    try {
+      const result = await bridge.writeSignalValues(values)
+      const failedCodes = Object.keys(result).filter(code => !result[code])
+      if (failedCodes.length > 0) {
+        logger.warn(`批量写入 ${failedCodes.length} 个信号失败`, { failedCodes })
+      } else {
+        logger.info(`批量写入 ${Object.keys(result).length} 个信号成功`)
+      }
+      return result
+    } catch (error) {
+      logger.error('批量写入信号失败', error)
+      return failed()
+    }
+  }
+
+  /**
+   * 读取参数组别的配方快照
+   * @description 批量读取组内全部信号，返回冻结的快照对象
+   * @param paramGroup - 参数组别
+   * @returns 配方快照，桥接不可用或调用失败时返回 null
+   */
+  async function readRecipeSnapshot(paramGroup: string): Promise<RecipeSnapshot | null> {
+    const bridge = getPlcBridge()
+    if (!bridge) {
+      logger.warn('PlcBridge 未初始化，无法读取配方快照')
+      return null
+    }
+
+    try {
+      const snapshot = await bridge.readGroupSnapshot(paramGroup)
+      if (snapshot.failedCodes.length > 0) {
+        logger.warn(`配方快照 ${paramGroup} 有 ${snapshot.failedCodes.length} 个信号读取失败`, {
+          failedCodes: snapshot.failedCodes
+        })
+      }
+      return Object.freeze({
+        paramGroup: snapshot.paramGroup,
+        values: Object.freeze({ ...snapshot.values }),
+        failedCodes: Object.freeze([...snapshot.failedCodes])
+      })
+    } catch (error) {
+      logger.error(`读取配方快照 ${paramGroup} 失败`, error)
+      return null
+    }
+  }
+
+  /**
+   * 按差异下载配方
+   * @description 只写入与 PLC 当前值不同的信号，写入后批量回读校验
+   * @param paramGroup - 参数组别
+   * @param recipe - 目标配方 {信号编码: 值}
+   * @returns 下载结果，桥接不可用或调用失败时全部计为失败
+   */
+  async function downloadRecipe(
+    paramGroup: string,
+    recipe: SignalValuesMap
+  ): Promise<RecipeDownloadResult> {
+    const failed = (): RecipeDownloadResult => ({
+      success: false,
+      written: [],
+      unchanged: [],
+      failed: Object.keys(recipe),
+      mismatched: []
+    })
+    const bridge = getPlcBridge()
+    if (!bridge) {
+      logger.warn('PlcBridge 未初始化，无法下载配方')
+      return failed()
+    }
+
+    try {
+      const result = await bridge.downloadRecipe(paramGroup, recipe)
+      const summary = {
+        written: result.written.length,
+        unchanged: result.unchanged.length,
+        failed: result.failed,
+        mismatched: result.mismatched
+      }
+      if (result.success) {
+        logger.info(`配方 ${paramGroup} 下载完成`, summary)
+      } else {
+        logger.warn(`配方 ${paramGroup} 下载未完全成功`, summary)
+      }
+      return result
+    } catch (error) {
+      logger.error(`下载配方 ${paramGroup} 失败`, error)
+      return failed()
+    }
+  }
+
   return {
     // 状态
     signals,
@@ -320,10 +612,15 @@ export const useSignalsStore = defineStore('signals', () => {
     updateValues,
     startPolling,
     stopPolling,
+    subscribe,
+    unsubscribe,
     initListeners,
     findSignalCodeByName,
     sendMesCommunicationStatus,
     readSingleSignal,
     writeSingleSignal,
+    writeSignals,
+    readRecipeSnapshot,
+    downloadRecipe,
   }
 })
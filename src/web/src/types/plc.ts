@@ -31,10 +31,18 @@ export interface ModbusSignal {
   registerCount: number
   scaleFactor: number
   offsetValue: number
+  /** 保持寄存器内的位序号（0-15），-1 或缺省表示使用整个寄存器 */
+  bitIndex?: number
   unit: string
   plcAreaType: string
   paramGroup: string
   isActive: boolean
+  /** 死区：变化量不超过死区时不上报，0 表示不启用 */
+  deadband?: number
+  /** 死区类型：absolute 绝对值，percent 相对上次上报值的百分比 */
+  deadbandType?: 'absolute' | 'percent'
+  /** 最小上报间隔（毫秒），0 表示不限制 */
+  minReportInterval?: number
 }
 
 /** 信号值接口 */
@@ -47,6 +55,119 @@ export interface SignalValue {
 /** 信号值映射 */
 export type SignalValuesMap = Record<string, number | boolean | string>
 
+/** 缓存值质量 */
+export type SignalQuality = 'good' | 'stale' | 'commError'
+
+/** 带质量标记的缓存值 */
+export interface CachedSignalValue {
+  value: number | boolean | string | null
+  quality: SignalQuality
+  /** 距最近一次成功读取的时长（毫秒），从未读取时为 -1 */
+  ageMs: number
+}
+
+/** 信号值快照（用于重新同步） */
+export interface SignalValuesSnapshot {
+  /** 当前推送版本号 */
+  version: number
+  /** 全部信号值 */
+  values: SignalValuesMap
+}
+
+/** 参数组别的配方快照（只读） */
+export interface RecipeSnapshot {
+  readonly paramGroup: string
+  /** 读取成功的信号值 */
+  readonly values: Readonly<SignalValuesMap>
+  /** 读取失败的信号编码 */
+  readonly failedCodes: readonly string[]
+}
+
+/** 配方下载结果 */
+export interface RecipeDownloadResult {
+  /** 全部信号写入（或无需写入）且回读一致 */
+  success: boolean
+  /** 已写入且回读校验通过的信号 */
+  written: string[]
+  /** 与 PLC 当前值相同、无需写入的信号 */
+  unchanged: string[]
+  /** 不属于该组别、不可写或写入失败的信号 */
+  failed: string[]
+  /** 回读值与目标不一致的信号 */
+  mismatched: string[]
+}
+
+/**
+ * 紧凑推送的信号索引表
+ * @description 紧凑推送按索引传输信号值，索引表在信号配置加载时下发一次
+ */
+export interface SignalSchema {
+  /** 索引表版本，与推送携带的版本不一致时需重新获取 */
+  schemaVersion: number
+  /** 索引 -> 信号编码 */
+  codes: string[]
+  /** 索引 -> 值类型，int64 信号不打包，仍通过 signalValuesChanged 推送 */
+  types: Array<'bool' | 'number' | 'int64'>
+}
+
+/** 轮询等级 */
+export type PollClass = 'fast' | 'normal' | 'slow'
+
+/** 单个轮询等级的周期统计 */
+export interface PollGroupStats {
+  /** 轮询周期（毫秒） */
+  intervalMs: number
+  /** 已完成周期数 */
+  cycleCount: number
+  /** 耗时超过周期的次数 */
+  overrunCount: number
+  /** 错过的周期数 */
+  skippedCycles: number
+  /** 周期耗时（毫秒） */
+  lastDurationMs: number
+  avgDurationMs: number
+  minDurationMs: number
+  maxDurationMs: number
+  /** 周期起点相对计划起点的延迟（毫秒） */
+  lastJitterMs: number
+  avgJitterMs: number
+  maxJitterMs: number
+}
+
+/** 轮询周期统计 */
+export interface PollStats {
+  /** 是否正在轮询 */
+  running: boolean
+  /** 各等级合计：已完成周期数 */
+  cycleCount: number
+  /** 各等级合计：超限次数 */
+  overrunCount: number
+  /** 各等级合计：错过的周期数 */
+  skippedCycles: number
+  /** 各轮询等级的统计 */
+  groups: Partial<Record<PollClass, PollGroupStats>>
+  /** 链路时延统计 */
+  link?: LinkStats
+}
+
+/** 链路时延统计（超时按实测往返时延自适应） */
+export interface LinkStats {
+  /** 平滑往返时延（毫秒） */
+  srttMs: number
+  /** 往返时延平均偏差（毫秒） */
+  rttVarMs: number
+  /** 当前请求超时（毫秒） */
+  timeoutMs: number
+  /** 往返时延样本数 */
+  samples: number
+  /** 超时次数 */
+  timeouts: number
+  /** 超时后重发次数 */
+  retries: number
+  /** 因连续超时判定链路中断的次数 */
+  linkDowns: number
+}
+
 /** 设备配置接口 */
 export interface ModbusDevice {
   deviceId: number
@@ -0,0 +1,43 @@
+/**
+ * 紧凑推送解码工具
+ * 解码 PlcBridge.signalValuesPacked 推送的二进制信号值
+ */
+
+import type { SignalSchema, SignalValuesMap } from '@/types/plc'
+
+/** 每个信号占用字节数：Float64 值 + Uint32 索引 */
+const BYTES_PER_ENTRY = 12
+
+/**
+ * 解码紧凑推送数据
+ * @param packed base64 数据：n 个 Float64 值在前，n 个 Uint32 索引在后（小端）
+ * @param schema 信号索引表
+ * @returns 信号值映射，数据格式不合法时返回 null
+ */
+export function decodePackedValues(packed: string, schema: SignalSchema): SignalValuesMap | null {
+  const binary = atob(packed)
+  if (binary.length % BYTES_PER_ENTRY !== 0) {
+    return null
+  }
+
+  const bytes = new Uint8Array(binary.length)
+  for (let i = 0; i < binary.length; i++) {
+    bytes[i] = binary.charCodeAt(i)
+  }
+
+  // 值位于缓冲区起始处，索引紧随其后，二者均满足 TypedArray 的对齐要求
+  const count = binary.length / BYTES_PER_ENTRY
+  const values = new Float64Array(bytes.buffer, 0, count)
+  const indices = new Uint32Array(bytes.buffer, count * 8, count)
+
+  const result: SignalValuesMap = {}
+  for (let i = 0; i < count; i++) {
+    const index = indices[i]
+    const code = schema.codes[index]
+    if (code === undefined) {
+      return null
+    }
+    result[code] = schema.types[index] === 'bool' ? values[i] !== 0 : values[i]
+  }
+  return result
+}
@@ -0,0 +1,281 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <cmath>
+#include <cstring>
+#include "modbus/BulkDecoder.h"
+#include "modbus/SignalCodec.h"
+#include "modbus/SignalTable.h"
+#include "modbus/RegisterImage.h"
+#include "modbus/ModbusSignal.h"
+
+/**
+ * @file tst_bulkdecoder.cpp
+ * @brief 批量解码器测试
+ * @description 用随机寄存器数据校验批量转换核函数与 SignalCodec::decode 逐个解码的结果一致，
+ *              并对比两条路径解码同一批信号的耗时
+ */
+
+namespace {
+/** 随机数据长度取奇数，覆盖向量循环之后的标量尾部 */
+constexpr int KernelCount = 1003;
+
+/** 基准测试的信号数量 */
+constexpr int BenchmarkSignals = 4000;
+
+QVector<quint16> randomWords(QRandomGenerator &rng, int count)
+{
+    QVector<quint16> words(count);
+    for (quint16 &word : words) {
+        word = static_cast<quint16>(rng.bounded(0x10000));
+    }
+    return words;
+}
+
+/** 浮点数按位比较，NaN 也视为一致 */
+bool sameValue(const QVariant &a, const QVariant &b)
+{
+    if (a.metaType() != b.metaType()) {
+        return false;
+    }
+    if (a.metaType().id() == QMetaType::Double) {
+        const double x = a.toDouble();
+        const double y = b.toDouble();
+        return std::memcmp(&x, &y, sizeof(double)) == 0;
+    }
+    return a == b;
+}
+
+SignalDecodeSpec specOf(DecodeKind kind, int registerCount)
+{
+    SignalDecodeSpec spec;
+    spec.decodeKind = kind;
+    spec.registerCount = static_cast<quint8>(registerCount);
+    return spec;
+}
+
+/**
+ * @brief 生成各解码类型混合、地址连续的信号配置
+ */
+QList<ModbusSignal> randomSignals(QRandomGenerator &rng, int count)
+{
+    QList<ModbusSignal> signalList;
+    int registerAddress = 0;
+    int coilAddress = 0;
+    for (int i = 0; i < count; ++i) {
+        ModbusSignal signal;
+        signal.signalCode = QStringLiteral("S%1").arg(i, 5, 10, QLatin1Char('0'));
+        signal.registerType = QStringLiteral("3");
+        signal.scaleFactor = 0;
+
+        switch (rng.bounded(7)) {
+        case 0:
+            signal.registerType = QStringLiteral("1");
+            signal.dataType = QStringLiteral("bit");
+            signal.registerAddress = coilAddress++;
+            break;
+        case 1:
+            signal.bitIndex = rng.bounded(16);
+            signal.offsetValue = registerAddress++;
+            break;
+        case 2:
+            signal.dataType = QStringLiteral("word");
+            signal.offsetValue = registerAddress++;
+            break;
+        case 3:
+            signal.dataType = QStringLiteral("word");
+            signal.scaleFactor = 1 + rng.bounded(3);
+            signal.offsetValue = registerAddress++;
+            break;
+        case 4:
+            signal.dataType = QStringLiteral("float");
+            signal.registerCount = 2;
+            signal.offsetValue = registerAddress;
+            registerAddress += 2;
+            break;
+        case 5:
+            signal.dataType = QStringLiteral("double");
+            signal.registerCount = 4;
+            signal.offsetValue = registerAddress;
+            registerAddress += 4;
+            break;
+        default:
+            signal.dataType = QStringLiteral("long");
+            signal.registerCount = 4;
+            signal.offsetValue = registerAddress;
+            registerAddress += 4;
+            break;
+        }
+        signalList.append(signal);
+    }
+    return signalList;
+}
+
+/** 影像所有块填入随机数据 */
+void fillImage(QRandomGenerator &rng, RegisterImage &image)
+{
+    for (int blockId = 0; blockId < image.blockCount(); ++blockId) {
+        const ImageBlock &block = image.block(blockId);
+        QVector<quint16> data = randomWords(rng, block.count);
+        if (block.registerType == ModbusManager::Coils) {
+            for (quint16 &bit : data) {
+                bit &= 1;
+            }
+        }
+        image.store(blockId, data.constData(), 0);
+    }
+}
+}
+
+class TestBulkDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void extractBitsMatchesDecode();
+    void scaleUInt16MatchesDecode();
+    void assembleFloat32MatchesDecode();
+    void assemble64MatchesDecode();
+    void decodeMatchesPerSignalDecode();
+
+    void benchmarkBulkDecode();
+    void benchmarkPerSignalDecode();
+
+private:
+    QRandomGenerator m_rng{20240601};
+};
+
+void TestBulkDecoder::extractBitsMatchesDecode()
+{
+    const QVector<quint16> words = randomWords(m_rng, KernelCount);
+    QVector<quint8> out(KernelCount);
+    BulkDecoder::extractBits(words.constData(), KernelCount, out.data());
+
+    const SignalDecodeSpec spec = specOf(DecodeKind::Bit, 1);
+    for (int i = 0; i < KernelCount; ++i) {
+        QCOMPARE(out[i] != 0, SignalCodec::decode(spec, words.constData() + i, 1).toBool());
+    }
+
+    // 零与非零各占一半时同样一致
+    QVector<quint16> sparse(KernelCount);
+    for (int i = 0; i < KernelCount; ++i) {
+        sparse[i] = (i & 1) ? words[i] : 0;
+    }
+    BulkDecoder::extractBits(sparse.constData(), KernelCount, out.data());
+    for (int i = 0; i < KernelCount; ++i) {
+        QCOMPARE(out[i] != 0, SignalCodec::decode(spec, sparse.constData() + i, 1).toBool());
+    }
+}
+
+void TestBulkDecoder::scaleUInt16MatchesDecode()
+{
+    const QVector<quint16> words = randomWords(m_rng, KernelCount);
+    QVector<double> divisors(KernelCount);
+    for (double &divisor : divisors) {
+        divisor = std::pow(10.0, 1 + m_rng.bounded(4));
+    }
+    QVector<double> out(KernelCount);
+    BulkDecoder::scaleUInt16(words.constData(), divisors.constData(), KernelCount, out.data());
+
+    for (int i = 0; i < KernelCount; ++i) {
+        SignalDecodeSpec spec = specOf(DecodeKind::UInt16Scaled, 1);
+        spec.scaled = true;
+        spec.scaleDivisor = divisors[i];
+        QVERIFY(sameValue(out[i], SignalCodec::decode(spec, words.constData() + i, 1)));
+    }
+}
+
+void TestBulkDecoder::assembleFloat32MatchesDecode()
+{
+    const QVector<quint16> words = randomWords(m_rng, 2 * KernelCount);
+    QVector<float> out(KernelCount);
+    BulkDecoder::assembleFloat32(words.constData(), KernelCount, out.data());
+
+    const SignalDecodeSpec spec = specOf(DecodeKind::Float32, 2);
+    for (int i = 0; i < KernelCount; ++i) {
+        const QVariant expected = SignalCodec::decode(spec, words.constData() + 2 * i, 2);
+        QVERIFY(sameValue(static_cast<double>(out[i]), expected));
+    }
+}
+
+void TestBulkDecoder::assemble64MatchesDecode()
+{
+    const QVector<quint16> words = randomWords(m_rng, 4 * KernelCount);
+    QVector<quint64> out(KernelCount);
+    BulkDecoder::assemble64(words.constData(), KernelCount, out.data());
+
+    const SignalDecodeSpec longSpec = specOf(DecodeKind::Int64, 4);
+    const SignalDecodeSpec doubleSpec = specOf(DecodeKind::Float64, 4);
+    for (int i = 0; i < KernelCount; ++i) {
+        const quint16 *raw = words.constData() + 4 * i;
+        QCOMPARE(static_cast<qint64>(out[i]), SignalCodec::decode(longSpec, raw, 4).toLongLong());
+
+        double doubleVal;
+        std::memcpy(&doubleVal, &out[i], sizeof(double));
+        QVERIFY(sameValue(doubleVal, SignalCodec::decode(doubleSpec, raw, 4)));
+    }
+}
+
+void TestBulkDecoder::decodeMatchesPerSignalDecode()
+{
+    SignalTable table;
+    table.rebuild(randomSignals(m_rng, 2000));
+    RegisterImage image;
+    image.build(table, 8);
+    fillImage(m_rng, image);
+
+    QVector<SignalHandle> handles;
+    for (SignalHandle handle = 0; handle < table.size(); ++handle) {
+        handles.append(handle);
+    }
+
+    BulkDecoder decoder;
+    QVector<QVariant> values;
+    decoder.decode(table, image, handles, values);
+    QCOMPARE(values.size(), handles.size());
+
+    for (int i = 0; i < handles.size(); ++i) {
+        const SignalHandle handle = handles[i];
+        const QVariant expected =
+            table.decode(handle, image.signalData(table, handle), table.registerCount(handle));
+        QVERIFY2(sameValue(values[i], expected), qPrintable(table.code(handle)));
+    }
+}
+
+void TestBulkDecoder::benchmarkBulkDecode()
+{
+    SignalTable table;
+    table.rebuild(randomSignals(m_rng, BenchmarkSignals));
+    RegisterImage image;
+    image.build(table, 8);
+    fillImage(m_rng, image);
+
+    QVector<SignalHandle> handles;
+    for (SignalHandle handle = 0; handle < table.size(); ++handle) {
+        handles.append(handle);
+    }
+
+    BulkDecoder decoder;
+    QVector<QVariant> values;
+    QBENCHMARK {
+        decoder.decode(table, image, handles, values);
+    }
+}
+
+void TestBulkDecoder::benchmarkPerSignalDecode()
+{
+    SignalTable table;
+    table.rebuild(randomSignals(m_rng, BenchmarkSignals));
+    RegisterImage image;
+    image.build(table, 8);
+    fillImage(m_rng, image);
+
+    QVector<QVariant> values(table.size());
+    QBENCHMARK {
+        for (SignalHandle handle = 0; handle < table.size(); ++handle) {
+            values[handle] = table.decode(handle, image.signalData(table, handle), table.registerCount(handle));
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestBulkDecoder)
+#include "tst_bulkdecoder.moc"
@@ -0,0 +1,287 @@
+#include <QtTest>
+#include <array>
+#include <cstring>
+#include "modbus/ModbusTcpCodec.h"
+#include "modbus/ModbusTcpTransport.h"
+
+/**
+ * @file tst_modbustcpcodec.cpp
+ * @brief Modbus TCP 编解码测试
+ * @description 校验请求 ADU 的编码字节、报文分帧、正常与异常响应的解析、
+ *              格式错误与失步报文的识别，以及事务 ID 回绕后的事务表槽位映射
+ */
+
+namespace {
+using Frame = std::array<quint8, ModbusTcpCodec::MaxAduSize>;
+
+/** 按给定字节构造报文 */
+Frame frameOf(std::initializer_list<int> bytes)
+{
+    Frame frame{};
+    int i = 0;
+    for (int byte : bytes) {
+        frame[i++] = static_cast<quint8>(byte);
+    }
+    return frame;
+}
+
+QByteArray bytesOf(const quint8 *data, int length)
+{
+    return QByteArray(reinterpret_cast<const char *>(data), length);
+}
+}
+
+class TestModbusTcpCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void encodeReadHoldingRegisters();
+    void encodeReadCoils();
+    void encodeWriteSingle();
+    void encodeWriteMultipleCoils();
+    void encodeWriteMultipleRegisters();
+    void encodeRejectsOutOfRange();
+
+    void frameLengthPartialAndComplete();
+    void frameLengthDetectsDesync();
+    void frameLengthSplitsConcatenatedFrames();
+
+    void decodeRegisterResponse();
+    void decodeCoilResponse();
+    void decodeWriteResponse();
+    void decodeExceptionResponse();
+    void decodeMalformedResponse();
+
+    void transactionIdWrapsAround();
+};
+
+void TestModbusTcpCodec::encodeReadHoldingRegisters()
+{
+    Frame out{};
+    const int length = ModbusTcpCodec::encodeRequest(out.data(), 0x1234, 0x01,
+                                                     ModbusTcpCodec::ReadHoldingRegisters, 0x0010, 125, nullptr);
+    QCOMPARE(length, 12);
+    QCOMPARE(bytesOf(out.data(), length),
+             QByteArray::fromHex("12340000000601030010007d"));
+}
+
+void TestModbusTcpCodec::encodeReadCoils()
+{
+    Frame out{};
+    const int length = ModbusTcpCodec::encodeRequest(out.data(), 7, 0x11, ModbusTcpCodec::ReadCoils,
+                                                     0x0013, 2000, nullptr);
+    QCOMPARE(bytesOf(out.data(), length), QByteArray::fromHex("0007000000061101001307d0"));
+}
+
+void TestModbusTcpCodec::encodeWriteSingle()
+{
+    Frame out{};
+    const quint16 on = 1;
+    int length = ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::WriteSingleCoil, 0x00AC, 1, &on);
+    QCOMPARE(bytesOf(out.data(), length), QByteArray::fromHex("000100000006010500acff00"));
+
+    const quint16 value = 0xABCD;
+    length = ModbusTcpCodec::encodeRequest(out.data(), 2, 1, ModbusTcpCodec::WriteSingleRegister, 0x0001, 1, &value);
+    QCOMPARE(bytesOf(out.data(), length), QByteArray::fromHex("00020000000601060001abcd"));
+}
+
+void TestModbusTcpCodec::encodeWriteMultipleCoils()
+{
+    // 10 个线圈 1,0,1,1,0,0,1,1,1,0 -> 0xCD 0x01
+    const quint16 bits[] = {1, 0, 1, 1, 0, 0, 1, 1, 1, 0};
+    Frame out{};
+    const int length = ModbusTcpCodec::encodeRequest(out.data(), 3, 1, ModbusTcpCodec::WriteMultipleCoils,
+                                                     0x0013, 10, bits);
+    QCOMPARE(bytesOf(out.data(), length), QByteArray::fromHex("000300000009010f0013000a02cd01"));
+}
+
+void TestModbusTcpCodec::encodeWriteMultipleRegisters()
+{
+    const quint16 values[] = {0x000A, 0x0102};
+    Frame out{};
+    const int length = ModbusTcpCodec::encodeRequest(out.data(), 4, 1, ModbusTcpCodec::WriteMultipleRegisters,
+                                                     0x0001, 2, values);
+    QCOMPARE(bytesOf(out.data(), length), QByteArray::fromHex("00040000000b01100001000204000a0102"));
+}
+
+void TestModbusTcpCodec::encodeRejectsOutOfRange()
+{
+    Frame out{};
+    std::array<quint16, ModbusTcpCodec::MaxWriteBits + 1> values{};
+    QCOMPARE(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::ReadHoldingRegisters, 0, 0, nullptr), 0);
+    QCOMPARE(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::ReadHoldingRegisters, 0,
+                                           ModbusTcpCodec::MaxReadRegisters + 1, nullptr), 0);
+    QCOMPARE(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::ReadCoils, 0,
+                                           ModbusTcpCodec::MaxReadBits + 1, nullptr), 0);
+    QCOMPARE(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::WriteMultipleRegisters, 0,
+                                           ModbusTcpCodec::MaxWriteRegisters + 1, values.data()), 0);
+    QCOMPARE(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::WriteMultipleCoils, 0,
+                                           ModbusTcpCodec::MaxWriteBits + 1, values.data()), 0);
+    QCOMPARE(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, 0x2B, 0, 1, nullptr), 0);
+
+    // 协议上限内的最大请求不超过 ADU 缓冲区
+    QVERIFY(ModbusTcpCodec::encodeRequest(out.data(), 1, 1, ModbusTcpCodec::WriteMultipleRegisters, 0,
+                                          ModbusTcpCodec::MaxWriteRegisters, values.data())
+            <= ModbusTcpCodec::MaxAduSize);
+}
+
+void TestModbusTcpCodec::frameLengthPartialAndComplete()
+{
+    // 读 2 个寄存器的响应：MBAP 长度 7 -> ADU 13 字节
+    const Frame frame = frameOf({0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x01, 0x03, 0x04, 0x00, 0x0A, 0x01, 0x02});
+    for (int size = 0; size < ModbusTcpCodec::HeaderSize; ++size) {
+        QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), size), 0);
+    }
+    QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), 12), 0);
+    QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), 13), 13);
+    QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), 20), 13);
+}
+
+void TestModbusTcpCodec::frameLengthDetectsDesync()
+{
+    // 协议 ID 非 0
+    Frame frame = frameOf({0x00, 0x01, 0x00, 0x01, 0x00, 0x06, 0x01});
+    QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), ModbusTcpCodec::HeaderSize), -1);
+
+    // 长度字段过小（不足单元 ID + 功能码）
+    frame = frameOf({0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x01});
+    QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), ModbusTcpCodec::HeaderSize), -1);
+
+    // 长度字段超过 PDU 上限
+    frame = frameOf({0x00, 0x01, 0x00, 0x00, 0x00, 0xFF, 0x01});
+    QCOMPARE(ModbusTcpCodec::frameLength(frame.data(), ModbusTcpCodec::HeaderSize), -1);
+
+    // 从报文中间开始解析（字节流失步）
+    const Frame response = frameOf({0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x01, 0x03, 0x04,
+                                    0xFF, 0xFF, 0x12, 0x34, 0x56, 0x78, 0x9A});
+    QCOMPARE(ModbusTcpCodec::frameLength(response.data() + 9, 7), -1);
+}
+
+void TestModbusTcpCodec::frameLengthSplitsConcatenatedFrames()
+{
+    // 写单个寄存器响应（12 字节）后紧跟异常响应（9 字节）
+    const Frame stream = frameOf({0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x01, 0x06, 0x00, 0x01, 0xAB, 0xCD,
+                                  0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x01, 0x83, 0x02});
+    const int first = ModbusTcpCodec::frameLength(stream.data(), 21);
+    QCOMPARE(first, 12);
+    QCOMPARE(ModbusTcpCodec::transactionId(stream.data()), quint16(1));
+
+    const int second = ModbusTcpCodec::frameLength(stream.data() + first, 21 - first);
+    QCOMPARE(second, 9);
+    QCOMPARE(ModbusTcpCodec::transactionId(stream.data() + first), quint16(2));
+}
+
+void TestModbusTcpCodec::decodeRegisterResponse()
+{
+    const Frame frame = frameOf({0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x01, 0x03, 0x04, 0x00, 0x0A, 0x01, 0x02});
+    std::array<quint16, 2> out{};
+    int exceptionCode = -1;
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 13, ModbusTcpCodec::ReadHoldingRegisters, 2,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Ok);
+    QCOMPARE(out[0], quint16(0x000A));
+    QCOMPARE(out[1], quint16(0x0102));
+}
+
+void TestModbusTcpCodec::decodeCoilResponse()
+{
+    // 10 个线圈：0xCD 0x01 -> 1,0,1,1,0,0,1,1,1,0
+    const Frame frame = frameOf({0x00, 0x06, 0x00, 0x00, 0x00, 0x05, 0x01, 0x01, 0x02, 0xCD, 0x01});
+    std::array<quint16, 10> out{};
+    int exceptionCode = -1;
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 11, ModbusTcpCodec::ReadCoils, 10,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Ok);
+    const quint16 expected[] = {1, 0, 1, 1, 0, 0, 1, 1, 1, 0};
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(out[i], expected[i]);
+    }
+}
+
+void TestModbusTcpCodec::decodeWriteResponse()
+{
+    const Frame frame = frameOf({0x00, 0x04, 0x00, 0x00, 0x00, 0x06, 0x01, 0x10, 0x00, 0x01, 0x00, 0x02});
+    int exceptionCode = -1;
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 12, ModbusTcpCodec::WriteMultipleRegisters, 2,
+                                            nullptr, &exceptionCode),
+             ModbusTcpCodec::Result::Ok);
+}
+
+void TestModbusTcpCodec::decodeExceptionResponse()
+{
+    // 非法数据地址
+    const Frame frame = frameOf({0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x01, 0x83, 0x02});
+    std::array<quint16, 2> out{};
+    int exceptionCode = 0;
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 9, ModbusTcpCodec::ReadHoldingRegisters, 2,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Exception);
+    QCOMPARE(exceptionCode, 0x02);
+
+    // 写请求的异常响应
+    const Frame writeFrame = frameOf({0x00, 0x03, 0x00, 0x00, 0x00, 0x03, 0x01, 0x90, 0x04});
+    QCOMPARE(ModbusTcpCodec::decodeResponse(writeFrame.data(), 9, ModbusTcpCodec::WriteMultipleRegisters, 2,
+                                            nullptr, &exceptionCode),
+             ModbusTcpCodec::Result::Exception);
+    QCOMPARE(exceptionCode, 0x04);
+}
+
+void TestModbusTcpCodec::decodeMalformedResponse()
+{
+    std::array<quint16, 4> out{};
+    int exceptionCode = 0;
+
+    // 功能码与请求不符
+    Frame frame = frameOf({0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x01, 0x04, 0x04, 0x00, 0x0A, 0x01, 0x02});
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 13, ModbusTcpCodec::ReadHoldingRegisters, 2,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Malformed);
+
+    // 字节数与请求数量不符
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 13, ModbusTcpCodec::ReadInputRegisters, 3,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Malformed);
+
+    // 字节数字段正确但数据不足
+    frame = frameOf({0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x01, 0x03, 0x04, 0x00, 0x0A});
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 11, ModbusTcpCodec::ReadHoldingRegisters, 2,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Malformed);
+
+    // 异常响应缺少异常码
+    frame = frameOf({0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x01, 0x83});
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 8, ModbusTcpCodec::ReadHoldingRegisters, 2,
+                                            out.data(), &exceptionCode),
+             ModbusTcpCodec::Result::Malformed);
+
+    // 写响应过短
+    frame = frameOf({0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x01, 0x10, 0x00, 0x01});
+    QCOMPARE(ModbusTcpCodec::decodeResponse(frame.data(), 10, ModbusTcpCodec::WriteMultipleRegisters, 2,
+                                            nullptr, &exceptionCode),
+             ModbusTcpCodec::Result::Malformed);
+}
+
+void TestModbusTcpCodec::transactionIdWrapsAround()
+{
+    // 事务 ID 为 16 位，0xFFFF 之后回绕到 0；按 MaxTransactions 取模的槽位在回绕前后保持连续，
+    // 任意连续 MaxTransactions 个事务 ID 占用互不相同的槽位
+    QCOMPARE(65536 % ModbusTcpTransport::MaxTransactions, 0);
+
+    quint16 id = 0xFFFF - ModbusTcpTransport::MaxTransactions / 2;
+    QVector<bool> used(ModbusTcpTransport::MaxTransactions, false);
+    for (int i = 0; i < ModbusTcpTransport::MaxTransactions; ++i, ++id) {
+        const int slot = id % ModbusTcpTransport::MaxTransactions;
+        QVERIFY2(!used[slot], qPrintable(QStringLiteral("事务 ID %1 的槽位已被占用").arg(id)));
+        used[slot] = true;
+
+        // 回绕前后的事务 ID 都能原样编码与解析
+        Frame out{};
+        ModbusTcpCodec::encodeRequest(out.data(), id, 1, ModbusTcpCodec::ReadHoldingRegisters, 0, 1, nullptr);
+        QCOMPARE(ModbusTcpCodec::transactionId(out.data()), id);
+    }
+    QCOMPARE(id, quint16(ModbusTcpTransport::MaxTransactions / 2 - 1));
+}
+
+QTEST_APPLESS_MAIN(TestModbusTcpCodec)
+#include "tst_modbustcpcodec.moc"
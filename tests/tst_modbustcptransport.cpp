@@ -0,0 +1,164 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QSet>
+#include <QtEndian>
+#include "modbus/ModbusTcpTransport.h"
+
+/**
+ * @file tst_modbustcptransport.cpp
+ * @brief Modbus TCP 传输层测试
+ * @description 用本地模拟 PLC 校验事务槽位的分配：长时间未响应的事务不挡住后续请求，
+ *              只有全部槽位在途时才拒绝发送
+ */
+
+namespace {
+/**
+ * @brief 模拟 PLC：按请求的寄存器数量返回全零数据，指定的事务 ID 不应答
+ */
+class FakePlc
+{
+public:
+    FakePlc()
+    {
+        QObject::connect(&m_server, &QTcpServer::newConnection, [this]() {
+            QTcpSocket *socket = m_server.nextPendingConnection();
+            QObject::connect(socket, &QIODevice::readyRead, socket, [this, socket]() { serve(socket); });
+        });
+        m_server.listen(QHostAddress::LocalHost);
+    }
+
+    quint16 port() const { return m_server.serverPort(); }
+
+    /** @brief 不应答该事务 ID */
+    void withhold(quint16 id) { m_withheld.insert(id); }
+
+    /** @brief 不应答任何请求 */
+    void setSilent(bool silent) { m_silent = silent; }
+
+private:
+    void serve(QTcpSocket *socket)
+    {
+        m_buffer += socket->readAll();
+        while (m_buffer.size() >= 7) {
+            const uchar *header = reinterpret_cast<const uchar *>(m_buffer.constData());
+            const int length = 6 + qFromBigEndian<quint16>(header + 4);
+            if (m_buffer.size() < length) {
+                return;
+            }
+            const quint16 id = qFromBigEndian<quint16>(header);
+            const quint8 unitId = header[6];
+            const quint8 function = header[7];
+            const quint16 count = qFromBigEndian<quint16>(header + 10);
+            m_buffer.remove(0, length);
+
+            if (m_silent || m_withheld.contains(id)) {
+                continue;
+            }
+
+            QByteArray response(9 + 2 * count, '\0');
+            uchar *out = reinterpret_cast<uchar *>(response.data());
+            qToBigEndian<quint16>(id, out);
+            qToBigEndian<quint16>(static_cast<quint16>(3 + 2 * count), out + 4);
+            out[6] = unitId;
+            out[7] = function;
+            out[8] = static_cast<quint8>(2 * count);
+            socket->write(response);
+        }
+    }
+
+    QTcpServer m_server;
+    QByteArray m_buffer;
+    QSet<quint16> m_withheld;
+    bool m_silent = false;
+};
+
+constexpr int LongTimeoutMs = 60000;
+}
+
+class TestModbusTcpTransport : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void pendingTransactionDoesNotBlockSlots();
+    void rejectsOnlyWhenAllSlotsActive();
+
+private:
+    /** @brief 发送读 1 个保持寄存器的请求 */
+    int sendRead(int timeoutMs = LongTimeoutMs)
+    {
+        return m_transport->send(1, ModbusTcpCodec::ReadHoldingRegisters, 0, 1, nullptr, timeoutMs);
+    }
+
+    FakePlc *m_plc = nullptr;
+    ModbusTcpTransport *m_transport = nullptr;
+    QHash<int, ModbusTcpTransport::Status> m_completed;  // 事务 ID -> 结果
+};
+
+void TestModbusTcpTransport::init()
+{
+    m_plc = new FakePlc;
+    m_transport = new ModbusTcpTransport;
+    m_completed.clear();
+    m_transport->setResponseHandler([this](int transactionId, ModbusTcpTransport::Status status, int,
+                                           const quint16 *, int) {
+        m_completed.insert(transactionId, status);
+    });
+
+    m_transport->connectDevice(QStringLiteral("127.0.0.1"), m_plc->port());
+    QTRY_COMPARE(m_transport->state(), QModbusDevice::ConnectedState);
+}
+
+void TestModbusTcpTransport::cleanup()
+{
+    delete m_transport;
+    m_transport = nullptr;
+    delete m_plc;
+    m_plc = nullptr;
+}
+
+void TestModbusTcpTransport::pendingTransactionDoesNotBlockSlots()
+{
+    // 第一个事务一直不应答，其余请求逐个完成，事务 ID 多次经过它占用的槽位
+    m_plc->withhold(1);
+    const int pending = sendRead();
+    QCOMPARE(pending, 1);
+
+    for (int i = 0; i < 3 * ModbusTcpTransport::MaxTransactions; ++i) {
+        const int id = sendRead();
+        QVERIFY2(id >= 0, qPrintable(m_transport->errorString()));
+        QVERIFY(id % ModbusTcpTransport::MaxTransactions != pending % ModbusTcpTransport::MaxTransactions);
+        QTRY_VERIFY(m_completed.contains(id));
+        QCOMPARE(m_completed.value(id), ModbusTcpTransport::Status::Success);
+    }
+    QVERIFY(!m_completed.contains(pending));
+}
+
+void TestModbusTcpTransport::rejectsOnlyWhenAllSlotsActive()
+{
+    m_plc->setSilent(true);
+
+    QSet<int> slotsUsed;
+    for (int i = 0; i < ModbusTcpTransport::MaxTransactions; ++i) {
+        const int id = sendRead();
+        QVERIFY2(id >= 0, qPrintable(m_transport->errorString()));
+        slotsUsed.insert(id % ModbusTcpTransport::MaxTransactions);
+    }
+    QCOMPARE(slotsUsed.size(), ModbusTcpTransport::MaxTransactions);
+    QCOMPARE(sendRead(), -1);
+
+    // 断开后全部在途事务以 Failed 结束
+    m_transport->disconnectDevice();
+    QTRY_COMPARE(m_completed.size(), ModbusTcpTransport::MaxTransactions);
+    for (ModbusTcpTransport::Status status : std::as_const(m_completed)) {
+        QCOMPARE(status, ModbusTcpTransport::Status::Failed);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestModbusTcpTransport)
+#include "tst_modbustcptransport.moc"
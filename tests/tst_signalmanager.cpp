@@ -0,0 +1,102 @@
+#include <QtTest>
+#include <QJsonDocument>
+#include "modbus/SignalManager.h"
+
+/**
+ * @file tst_signalmanager.cpp
+ * @brief 信号管理器测试
+ * @description 校验从 ERP JSON 加载信号配置时 bitIndex 的解析：缺失、null 与非数字表示使用整个寄存器，
+ *              0-15 表示寄存器内的位
+ */
+
+namespace {
+/** 保持寄存器中的普通字信号，bitIndex 由调用方填入 */
+QVariantMap wordSignal()
+{
+    QVariantMap map;
+    map["signalCode"] = QStringLiteral("S1");
+    map["registerType"] = QStringLiteral("3");
+    map["dataType"] = QStringLiteral("word");
+    map["offsetValue"] = 100;
+    map["scaleFactor"] = 0;
+    return map;
+}
+}
+
+class TestSignalManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void loadBitIndex_data();
+    void loadBitIndex();
+    void loadBitIndexFromErpJson();
+};
+
+void TestSignalManager::loadBitIndex_data()
+{
+    QTest::addColumn<bool>("present");
+    QTest::addColumn<QVariant>("bitIndex");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("missing") << false << QVariant() << -1;
+    QTest::newRow("null") << true << QVariant::fromValue(nullptr) << -1;
+    QTest::newRow("invalid") << true << QVariant() << -1;
+    QTest::newRow("empty string") << true << QVariant(QString()) << -1;
+    QTest::newRow("non-numeric") << true << QVariant(QStringLiteral("x")) << -1;
+    for (int bit = 0; bit < 16; ++bit) {
+        QTest::newRow(qPrintable(QStringLiteral("bit %1").arg(bit))) << true << QVariant(bit) << bit;
+    }
+    QTest::newRow("numeric string") << true << QVariant(QStringLiteral("7")) << 7;
+}
+
+void TestSignalManager::loadBitIndex()
+{
+    QFETCH(bool, present);
+    QFETCH(QVariant, bitIndex);
+    QFETCH(int, expected);
+
+    QVariantMap map = wordSignal();
+    if (present) {
+        map["bitIndex"] = bitIndex;
+    }
+
+    SignalManager manager(nullptr, nullptr);
+    manager.loadSignalsFromJson(QVariantList{map});
+
+    QCOMPARE(manager.getSignal(QStringLiteral("S1")).bitIndex, expected);
+
+    const SignalTable &table = manager.signalTable();
+    const SignalHandle handle = table.handleOf(QStringLiteral("S1"));
+    QVERIFY(handle != SignalTable::InvalidHandle);
+    if (expected < 0) {
+        QCOMPARE(table.decodeKind(handle), DecodeKind::UInt16);
+    } else {
+        QCOMPARE(table.decodeKind(handle), DecodeKind::BitInWord);
+        QCOMPARE(table.bitIndex(handle), expected);
+    }
+}
+
+void TestSignalManager::loadBitIndexFromErpJson()
+{
+    // 经 QJsonDocument 转换的 ERP 响应：未设置的 Integer 字段为 null
+    const QByteArray json = R"([
+        {"signalCode": "W", "registerType": "3", "dataType": "word", "scaleFactor": 0, "offsetValue": 10, "bitIndex": null},
+        {"signalCode": "B", "registerType": "3", "dataType": "word", "scaleFactor": 0, "offsetValue": 11, "bitIndex": 0},
+        {"signalCode": "M", "registerType": "3", "dataType": "word", "scaleFactor": 0, "offsetValue": 12}
+    ])";
+    SignalManager manager(nullptr, nullptr);
+    manager.loadSignalsFromJson(QJsonDocument::fromJson(json).toVariant().toList());
+
+    QCOMPARE(manager.getSignal(QStringLiteral("W")).bitIndex, -1);
+    QCOMPARE(manager.getSignal(QStringLiteral("B")).bitIndex, 0);
+    QCOMPARE(manager.getSignal(QStringLiteral("M")).bitIndex, -1);
+
+    const SignalTable &table = manager.signalTable();
+    QCOMPARE(table.decodeKind(table.handleOf(QStringLiteral("W"))), DecodeKind::UInt16);
+    QCOMPARE(table.decodeKind(table.handleOf(QStringLiteral("B"))), DecodeKind::BitInWord);
+    QCOMPARE(table.decodeKind(table.handleOf(QStringLiteral("M"))), DecodeKind::UInt16);
+}
+
+QTEST_APPLESS_MAIN(TestSignalManager)
+#include "tst_signalmanager.moc"